@@ -0,0 +1,400 @@
+#ifndef LINQ_PLUSPLUS_AGGREGATORS_H
+#define LINQ_PLUSPLUS_AGGREGATORS_H
+
+#include "Optional.h"
+#include <cmath>
+#include <limits>
+#include <stddef.h>
+#include <stdint.h>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace LinqPlusPlus
+{
+    // The accumulators IEnumerable::aggregate_many evaluates together in a single pass. Each one describes what to
+    // compute; its State<T> computes it over elements of type T. States fold a run of elements at a time in a plain
+    // loop, and selectors are template parameters rather than std::function, so over arithmetic elements and fields
+    // the loops inline and vectorize.
+    namespace Aggregators
+    {
+        struct Identity
+        {
+            template <typename T>
+            const T& operator()(const T& t) const
+            {
+                return t;
+            }
+        };
+
+        // The type a selector picks out of an element.
+        template <typename TSelector, typename T>
+        struct Selected
+        {
+            typedef typename std::decay<decltype(std::declval<const TSelector&>()(std::declval<const T&>()))>::type type;
+        };
+
+        // Integral values are totalled in 64 bits, floating point ones in double.
+        template <typename TValue>
+        struct Total
+        {
+            typedef typename std::conditional<std::is_floating_point<TValue>::value, double,
+                typename std::conditional<std::is_signed<TValue>::value, int64_t, uint64_t>::type>::type type;
+        };
+
+        // A floating point total with Neumaier's compensation, which keeps the low order bits each addition rounds
+        // away; for totals that have values taken back out of them, like a sliding window's, so the error doesn't
+        // build up as the window moves along.
+        class CompensatedSum
+        {
+        public:
+            CompensatedSum()
+                : sum_(0.0)
+                , compensation_(0.0)
+            {
+            }
+
+            CompensatedSum add(double value) const
+            {
+                CompensatedSum result;
+                result.sum_ = sum_ + value;
+                result.compensation_ = compensation_ + (std::fabs(sum_) >= std::fabs(value)
+                    ? (sum_ - result.sum_) + value
+                    : (value - result.sum_) + sum_);
+
+                return result;
+            }
+
+            double value() const
+            {
+                return sum_ + compensation_;
+            }
+
+        private:
+            double sum_;
+            double compensation_;
+        };
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        struct Count
+        {
+            template <typename T>
+            class State
+            {
+            public:
+                typedef size_t result_type;
+
+                explicit State(const Count&)
+                    : count_(0)
+                {
+                }
+
+                void add(const T*, size_t size)
+                {
+                    count_ += size;
+                }
+
+                result_type result() const
+                {
+                    return count_;
+                }
+
+            private:
+                size_t count_;
+            };
+        };
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        template <typename TSelector>
+        struct Sum
+        {
+            TSelector selector;
+
+            template <typename T>
+            class State
+            {
+            public:
+                typedef typename Selected<TSelector, T>::type result_type;
+
+                explicit State(const Sum& sum)
+                    : selector_(sum.selector)
+                    , sum_()
+                {
+                }
+
+                void add(const T* elements, size_t size)
+                {
+                    result_type sum = sum_;
+                    for (size_t i = 0; i < size; ++i)
+                    {
+                        sum += selector_(elements[i]);
+                    }
+                    sum_ = sum;
+                }
+
+                result_type result() const
+                {
+                    return sum_;
+                }
+
+            private:
+                TSelector selector_;
+                result_type sum_;
+            };
+        };
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // The least (or with Greater, the greatest) selected value; empty for an empty sequence.
+        template <typename TSelector, bool Greater>
+        struct Extreme
+        {
+            TSelector selector;
+
+            template <typename T>
+            class State
+            {
+            public:
+                typedef typename Selected<TSelector, T>::type value_type;
+                typedef Optional<value_type> result_type;
+
+                explicit State(const Extreme& extreme)
+                    : selector_(extreme.selector)
+                    , extreme_()
+                    , empty_(true)
+                {
+                }
+
+                void add(const T* elements, size_t size)
+                {
+                    if (size == 0)
+                    {
+                        return;
+                    }
+
+                    value_type extreme = empty_ ? selector_(elements[0]) : extreme_;
+                    for (size_t i = 0; i < size; ++i)
+                    {
+                        value_type value = selector_(elements[i]);
+                        extreme = (Greater ? extreme < value : value < extreme) ? value : extreme;
+                    }
+
+                    extreme_ = extreme;
+                    empty_ = false;
+                }
+
+                result_type result() const
+                {
+                    return empty_ ? result_type() : result_type(extreme_);
+                }
+
+            private:
+                TSelector selector_;
+                value_type extreme_;
+                bool empty_;
+            };
+        };
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // NaN for an empty sequence, like IEnumerable::average.
+        template <typename TSelector>
+        struct Average
+        {
+            TSelector selector;
+
+            template <typename T>
+            class State
+            {
+            public:
+                typedef double result_type;
+                typedef typename Total<typename Selected<TSelector, T>::type>::type total_type;
+
+                explicit State(const Average& average)
+                    : selector_(average.selector)
+                    , total_()
+                    , count_(0)
+                {
+                }
+
+                void add(const T* elements, size_t size)
+                {
+                    total_type total = total_;
+                    for (size_t i = 0; i < size; ++i)
+                    {
+                        total += selector_(elements[i]);
+                    }
+
+                    total_ = total;
+                    count_ += size;
+                }
+
+                result_type result() const
+                {
+                    return count_ == 0 ? std::numeric_limits<double>::quiet_NaN() : static_cast<double>(total_) / count_;
+                }
+
+            private:
+                TSelector selector_;
+                total_type total_;
+                size_t count_;
+            };
+        };
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Any other accumulation, folded an element at a time like IEnumerable::aggregate.
+        template <typename TAccumulate, typename TAccumulator>
+        struct Fold
+        {
+            TAccumulate seed;
+            TAccumulator accumulator;
+
+            template <typename T>
+            class State
+            {
+            public:
+                typedef TAccumulate result_type;
+
+                explicit State(const Fold& fold)
+                    : accumulator_(fold.accumulator)
+                    , accumulated_(fold.seed)
+                {
+                }
+
+                void add(const T* elements, size_t size)
+                {
+                    for (size_t i = 0; i < size; ++i)
+                    {
+                        accumulated_ = accumulator_(accumulated_, elements[i]);
+                    }
+                }
+
+                result_type result() const
+                {
+                    return accumulated_;
+                }
+
+            private:
+                TAccumulator accumulator_;
+                TAccumulate accumulated_;
+            };
+        };
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        inline Count count()
+        {
+            return Count();
+        }
+
+        inline Sum<Identity> sum()
+        {
+            return Sum<Identity>();
+        }
+
+        template <typename TSelector>
+        Sum<TSelector> sum(TSelector selector)
+        {
+            return Sum<TSelector>{ selector };
+        }
+
+        inline Extreme<Identity, false> min()
+        {
+            return Extreme<Identity, false>();
+        }
+
+        template <typename TSelector>
+        Extreme<TSelector, false> min(TSelector selector)
+        {
+            return Extreme<TSelector, false>{ selector };
+        }
+
+        inline Extreme<Identity, true> max()
+        {
+            return Extreme<Identity, true>();
+        }
+
+        template <typename TSelector>
+        Extreme<TSelector, true> max(TSelector selector)
+        {
+            return Extreme<TSelector, true>{ selector };
+        }
+
+        inline Average<Identity> average()
+        {
+            return Average<Identity>();
+        }
+
+        template <typename TSelector>
+        Average<TSelector> average(TSelector selector)
+        {
+            return Average<TSelector>{ selector };
+        }
+
+        template <typename TAccumulate, typename TAccumulator>
+        Fold<TAccumulate, TAccumulator> fold(const TAccumulate& seed, TAccumulator accumulator)
+        {
+            return Fold<TAccumulate, TAccumulator>{ seed, accumulator };
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // The states of several accumulators over elements of type T, each fed every run in turn.
+        template <typename T, typename... TAggregators>
+        class Many;
+
+        template <typename T>
+        class Many<T>
+        {
+        public:
+            typedef std::tuple<> result_type;
+
+            void add(const T*, size_t)
+            {
+            }
+
+            std::tuple<> result() const
+            {
+                return std::tuple<>();
+            }
+        };
+
+        template <typename T, typename TFirst, typename... TRest>
+        class Many<T, TFirst, TRest...>
+        {
+        public:
+            typedef std::tuple<typename TFirst::template State<T>::result_type,
+                typename TRest::template State<T>::result_type...> result_type;
+
+            explicit Many(const TFirst& first, const TRest&... rest)
+                : first_(first)
+                , rest_(rest...)
+            {
+            }
+
+            void add(const T* elements, size_t size)
+            {
+                first_.add(elements, size);
+                rest_.add(elements, size);
+            }
+
+            result_type result() const
+            {
+                return std::tuple_cat(std::make_tuple(first_.result()), rest_.result());
+            }
+
+        private:
+            typename TFirst::template State<T> first_;
+            Many<T, TRest...> rest_;
+        };
+
+        // What IEnumerable::stats computes.
+        template <typename TValue>
+        struct Statistics
+        {
+            size_t count;
+            TValue sum;
+            TValue min;
+            TValue max;
+            double average;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef LINQ_PLUSPLUS_BACKOFF_H
+#define LINQ_PLUSPLUS_BACKOFF_H
+
+#include <chrono>
+#include <stddef.h>
+#include <thread>
+
+namespace LinqPlusPlus
+{
+    namespace Concurrency
+    {
+        // Waits between polls of a lock-free structure: busy spins first, since the other side is usually only a
+        // few instructions away, then yields, then sleeps so that a long wait doesn't keep a core busy. A backoff
+        // that doesn't sleep trades that core for latency.
+        class Backoff
+        {
+        public:
+            explicit Backoff(bool sleeps = true)
+                : polls_(0)
+                , sleeps_(sleeps)
+            {
+            }
+
+            void wait()
+            {
+                if (polls_ < SpinPolls)
+                {
+                    ++polls_;
+                }
+                else if (polls_ < SpinPolls + YieldPolls || !sleeps_)
+                {
+                    ++polls_;
+                    std::this_thread::yield();
+                }
+                else
+                {
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                }
+            }
+
+            void reset()
+            {
+                polls_ = 0;
+            }
+
+        private:
+            static const size_t SpinPolls = 64;
+            static const size_t YieldPolls = 1024;
+
+            size_t polls_;
+            bool sleeps_;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,191 @@
+#ifndef LINQ_PLUSPLUS_BOUNDED_QUEUE_H
+#define LINQ_PLUSPLUS_BOUNDED_QUEUE_H
+
+#include "Backoff.h"
+#include "../Optional.h"
+#include <atomic>
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+
+namespace LinqPlusPlus
+{
+    namespace Concurrency
+    {
+        // A bounded lock-free queue for any number of producer and consumer threads (Vyukov's array queue). Each
+        // cell carries a sequence number saying whether it is ready to be written or read at a given position, so
+        // producers and consumers only contend on their own position counter. Closing the queue marks the end of
+        // the stream: consumers drain what is left and then stop.
+        template <typename T>
+        class BoundedQueue
+        {
+        public:
+            // The capacity is rounded up to a power of two, and is at least two.
+            explicit BoundedQueue(size_t capacity)
+                : capacity_(round_up(capacity))
+                , mask_(capacity_ - 1)
+                , cells_(new Cell[capacity_])
+                , enqueuePosition_(0)
+                , dequeuePosition_(0)
+                , closed_(false)
+            {
+                for (size_t i = 0; i < capacity_; ++i)
+                {
+                    cells_[i].sequence.store(i, std::memory_order_relaxed);
+                }
+            }
+
+            size_t capacity() const
+            {
+                return capacity_;
+            }
+
+            // Returns false, leaving value untouched, if the queue is full or closed.
+            bool try_push(T&& value)
+            {
+                if (closed())
+                {
+                    return false;
+                }
+
+                size_t position = enqueuePosition_.load(std::memory_order_relaxed);
+                Cell* cell;
+
+                for (;;)
+                {
+                    cell = &cells_[position & mask_];
+                    size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                    intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+                    if (difference == 0)
+                    {
+                        if (enqueuePosition_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                        {
+                            break;
+                        }
+                    }
+                    else if (difference < 0)
+                    {
+                        return false;
+                    }
+                    else
+                    {
+                        position = enqueuePosition_.load(std::memory_order_relaxed);
+                    }
+                }
+
+                cell->value = Optional<T>(std::move(value));
+                cell->sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+
+            bool try_push(const T& value)
+            {
+                T copy(value);
+                return try_push(std::move(copy));
+            }
+
+            // Waits for room. Returns false if the queue is closed.
+            bool push(T value)
+            {
+                Backoff backoff;
+
+                while (!try_push(std::move(value)))
+                {
+                    if (closed())
+                    {
+                        return false;
+                    }
+
+                    backoff.wait();
+                }
+
+                return true;
+            }
+
+            // Returns false if the queue is empty.
+            bool try_pop(Optional<T>& value)
+            {
+                size_t position = dequeuePosition_.load(std::memory_order_relaxed);
+                Cell* cell;
+
+                for (;;)
+                {
+                    cell = &cells_[position & mask_];
+                    size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                    intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+
+                    if (difference == 0)
+                    {
+                        if (dequeuePosition_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                        {
+                            break;
+                        }
+                    }
+                    else if (difference < 0)
+                    {
+                        return false;
+                    }
+                    else
+                    {
+                        position = dequeuePosition_.load(std::memory_order_relaxed);
+                    }
+                }
+
+                value = std::move(cell->value);
+                cell->value.reset();
+                cell->sequence.store(position + capacity_, std::memory_order_release);
+                return true;
+            }
+
+            // Ends the stream. Call it once every producer has finished pushing.
+            void close()
+            {
+                closed_.store(true, std::memory_order_release);
+            }
+
+            bool closed() const
+            {
+                return closed_.load(std::memory_order_acquire);
+            }
+
+        private:
+            BoundedQueue(const BoundedQueue&);
+            BoundedQueue& operator=(const BoundedQueue&);
+
+            struct Cell
+            {
+                std::atomic<size_t> sequence;
+                Optional<T> value;
+            };
+
+            static size_t round_up(size_t capacity)
+            {
+                size_t size = 2;
+
+                while (size < capacity)
+                {
+                    size <<= 1;
+                }
+
+                return size;
+            }
+
+            static const size_t CacheLine = 64;
+
+            const size_t capacity_;
+            const size_t mask_;
+            std::unique_ptr<Cell[]> cells_;
+
+            char padding0_[CacheLine];
+            std::atomic<size_t> enqueuePosition_;
+            char padding1_[CacheLine];
+            std::atomic<size_t> dequeuePosition_;
+            char padding2_[CacheLine];
+            std::atomic<bool> closed_;
+        };
+    }
+}
+
+#endif
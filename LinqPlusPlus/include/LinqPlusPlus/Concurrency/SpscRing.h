@@ -0,0 +1,128 @@
+#ifndef LINQ_PLUSPLUS_SPSC_RING_H
+#define LINQ_PLUSPLUS_SPSC_RING_H
+
+#include "../Optional.h"
+#include <atomic>
+#include <stddef.h>
+#include <utility>
+#include <vector>
+
+namespace LinqPlusPlus
+{
+    namespace Concurrency
+    {
+        // A bounded lock-free queue for exactly one producer thread and one consumer thread. Each side keeps a
+        // cached copy of the other's index and only reloads it when the ring looks full (or empty), so a consumer
+        // that has fallen behind drains a whole batch of elements without touching the producer's cache line.
+        template <typename T>
+        class SpscRing
+        {
+        public:
+            // The capacity is rounded up to a power of two.
+            explicit SpscRing(size_t capacity)
+                : slots_(round_up(capacity))
+                , mask_(slots_.size() - 1)
+                , head_(0)
+                , cachedTail_(0)
+                , tail_(0)
+                , cachedHead_(0)
+            {
+            }
+
+            size_t capacity() const
+            {
+                return slots_.size();
+            }
+
+            // Producer only. Leaves value untouched and returns false if the ring is full.
+            bool try_push(T&& value)
+            {
+                size_t tail = tail_.load(std::memory_order_relaxed);
+
+                if (tail - cachedHead_ == slots_.size())
+                {
+                    cachedHead_ = head_.load(std::memory_order_acquire);
+
+                    if (tail - cachedHead_ == slots_.size())
+                    {
+                        return false;
+                    }
+                }
+
+                slots_[tail & mask_] = Optional<T>(std::move(value));
+                tail_.store(tail + 1, std::memory_order_release);
+                return true;
+            }
+
+            // Consumer only. Returns false if the ring is empty.
+            bool try_pop(Optional<T>& value)
+            {
+                size_t head = head_.load(std::memory_order_relaxed);
+
+                if (head == cachedTail_)
+                {
+                    cachedTail_ = tail_.load(std::memory_order_acquire);
+
+                    if (head == cachedTail_)
+                    {
+                        return false;
+                    }
+                }
+
+                Optional<T>& slot = slots_[head & mask_];
+                value = std::move(slot);
+                slot.reset();
+                head_.store(head + 1, std::memory_order_release);
+                return true;
+            }
+
+            // Only while neither side is using the ring.
+            void clear()
+            {
+                for (auto& slot : slots_)
+                {
+                    slot.reset();
+                }
+
+                head_.store(0, std::memory_order_relaxed);
+                tail_.store(0, std::memory_order_relaxed);
+                cachedHead_ = 0;
+                cachedTail_ = 0;
+            }
+
+        private:
+            SpscRing(const SpscRing&);
+            SpscRing& operator=(const SpscRing&);
+
+            static size_t round_up(size_t capacity)
+            {
+                size_t size = 1;
+
+                while (size < capacity)
+                {
+                    size <<= 1;
+                }
+
+                return size;
+            }
+
+            static const size_t CacheLine = 64;
+
+            std::vector<Optional<T> > slots_;
+            const size_t mask_;
+
+            // Written by the consumer.
+            char padding0_[CacheLine];
+            std::atomic<size_t> head_;
+            size_t cachedTail_;
+
+            // Written by the producer.
+            char padding1_[CacheLine];
+            std::atomic<size_t> tail_;
+            size_t cachedHead_;
+            char padding2_[CacheLine];
+        };
+    }
+}
+
+#endif
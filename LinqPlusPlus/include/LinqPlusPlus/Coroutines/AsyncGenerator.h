@@ -0,0 +1,259 @@
+#ifndef LINQ_PLUSPLUS_ASYNC_GENERATOR_H
+#define LINQ_PLUSPLUS_ASYNC_GENERATOR_H
+
+#if !defined(__cpp_impl_coroutine)
+#error "LinqPlusPlus generators require C++20 coroutines, configure with -DLINQPLUSPLUS_CXX20=ON"
+#endif
+
+#include "FrameArena.h"
+#include "../Optional.h"
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace LinqPlusPlus
+{
+    namespace Coroutines
+    {
+        // The return type of a coroutine that produces a sequence with co_yield and may co_await in between, for
+        // example on I/O. A consumer that is itself a coroutine co_awaits move_next(): it is suspended, rather than
+        // blocking its thread, until the generator yields, and then resumed on whichever thread the generator was
+        // running on. Anything else calls wait_next(), which blocks until then.
+        template <typename T>
+        class AsyncGenerator
+        {
+        public:
+            typedef T value_type;
+
+            struct promise_type;
+
+        private:
+            // Lets wait_next() sleep until the generator yields. Shared so that the generator can still signal it
+            // after the waiting thread has woken up and destroyed the generator.
+            struct Signal
+            {
+                Signal()
+                    : ready(false)
+                {
+                }
+
+                std::mutex mutex;
+                std::condition_variable condition;
+                bool ready;
+            };
+
+            // Hands control back to the consumer when the generator yields or finishes.
+            struct YieldAwaiter
+            {
+                bool await_ready() noexcept
+                {
+                    return false;
+                }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+                {
+                    // The consumer may resume or destroy this frame as soon as it is signalled, so take everything
+                    // needed from it first.
+                    std::coroutine_handle<> consumer = handle.promise().consumer;
+                    std::shared_ptr<Signal> signal = handle.promise().signal;
+
+                    if (signal != nullptr)
+                    {
+                        std::lock_guard<std::mutex> lock(signal->mutex);
+                        signal->ready = true;
+                        signal->condition.notify_one();
+                    }
+
+                    return consumer;
+                }
+
+                void await_resume() noexcept
+                {
+                }
+            };
+
+        public:
+            struct promise_type
+            {
+                Optional<T> current;
+                std::exception_ptr error;
+                std::coroutine_handle<> consumer;
+                std::shared_ptr<Signal> signal;
+
+                AsyncGenerator get_return_object()
+                {
+                    return AsyncGenerator(std::coroutine_handle<promise_type>::from_promise(*this));
+                }
+
+                std::suspend_always initial_suspend() noexcept
+                {
+                    return std::suspend_always();
+                }
+
+                YieldAwaiter final_suspend() noexcept
+                {
+                    return YieldAwaiter();
+                }
+
+                YieldAwaiter yield_value(T value)
+                {
+                    current = Optional<T>(std::move(value));
+                    return YieldAwaiter();
+                }
+
+                void return_void()
+                {
+                }
+
+                void unhandled_exception()
+                {
+                    error = std::current_exception();
+                }
+
+                static void* operator new(size_t size)
+                {
+                    return FrameArena::allocate(size);
+                }
+
+                static void operator delete(void* frame, size_t size)
+                {
+                    FrameArena::deallocate(frame, size);
+                }
+            };
+
+            // Awaited by move_next(): runs the generator, by symmetric transfer, until it yields or finishes.
+            class NextAwaiter
+            {
+            public:
+                explicit NextAwaiter(AsyncGenerator& generator)
+                    : generator_(generator)
+                {
+                }
+
+                bool await_ready() noexcept
+                {
+                    return !generator_.handle_ || generator_.handle_.done();
+                }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> consumer) noexcept
+                {
+                    generator_.handle_.promise().consumer = consumer;
+                    generator_.handle_.promise().signal = nullptr;
+                    return generator_.handle_;
+                }
+
+                bool await_resume()
+                {
+                    return generator_.advanced();
+                }
+
+            private:
+                AsyncGenerator& generator_;
+            };
+
+            AsyncGenerator(AsyncGenerator&& other) noexcept
+                : handle_(other.handle_)
+                , signal_(std::move(other.signal_))
+            {
+                other.handle_ = nullptr;
+            }
+
+            ~AsyncGenerator()
+            {
+                if (handle_)
+                {
+                    handle_.destroy();
+                }
+            }
+
+            AsyncGenerator& operator=(AsyncGenerator&& rhs) noexcept
+            {
+                if (this != &rhs)
+                {
+                    if (handle_)
+                    {
+                        handle_.destroy();
+                    }
+
+                    handle_ = rhs.handle_;
+                    signal_ = std::move(rhs.signal_);
+                    rhs.handle_ = nullptr;
+                }
+
+                return *this;
+            }
+
+            // co_await it for true once the generator has yielded its next element, false once it has finished.
+            NextAwaiter move_next()
+            {
+                return NextAwaiter(*this);
+            }
+
+            // As move_next(), blocking the calling thread instead of suspending a coroutine.
+            bool wait_next()
+            {
+                if (!handle_ || handle_.done())
+                {
+                    return false;
+                }
+
+                if (signal_ == nullptr)
+                {
+                    signal_ = std::make_shared<Signal>();
+                }
+
+                signal_->ready = false;
+                handle_.promise().consumer = std::noop_coroutine();
+                handle_.promise().signal = signal_;
+                handle_.resume();
+
+                {
+                    std::unique_lock<std::mutex> lock(signal_->mutex);
+                    signal_->condition.wait(lock, [this](){ return signal_->ready; });
+                }
+
+                return advanced();
+            }
+
+            T& current_ref()
+            {
+                return *handle_.promise().current;
+            }
+
+        private:
+            AsyncGenerator(const AsyncGenerator&) = delete;
+            AsyncGenerator& operator=(const AsyncGenerator&) = delete;
+
+            explicit AsyncGenerator(std::coroutine_handle<promise_type> handle)
+                : handle_(handle)
+            {
+            }
+
+            bool advanced()
+            {
+                if (!handle_)
+                {
+                    return false;
+                }
+
+                promise_type& promise = handle_.promise();
+                if (promise.error != nullptr)
+                {
+                    std::exception_ptr error = promise.error;
+                    promise.error = nullptr;
+                    std::rethrow_exception(error);
+                }
+
+                return !handle_.done();
+            }
+
+            std::coroutine_handle<promise_type> handle_;
+            std::shared_ptr<Signal> signal_;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef LINQ_PLUSPLUS_FRAME_ARENA_H
+#define LINQ_PLUSPLUS_FRAME_ARENA_H
+
+#include <stddef.h>
+
+namespace LinqPlusPlus
+{
+    namespace Coroutines
+    {
+        // Allocates generator coroutine frames. A freed frame is kept on the freeing thread's free list for its size
+        // class and handed to the next frame of that size, so enumerating a generator query again, which starts a
+        // new coroutine, doesn't go back to the global allocator.
+        class FrameArena
+        {
+        public:
+            static void* allocate(size_t size);
+            static void deallocate(void* frame, size_t size);
+        };
+    }
+}
+
+#endif
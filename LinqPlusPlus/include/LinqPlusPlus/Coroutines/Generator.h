@@ -0,0 +1,144 @@
+#ifndef LINQ_PLUSPLUS_GENERATOR_H
+#define LINQ_PLUSPLUS_GENERATOR_H
+
+#if !defined(__cpp_impl_coroutine)
+#error "LinqPlusPlus generators require C++20 coroutines, configure with -DLINQPLUSPLUS_CXX20=ON"
+#endif
+
+#include "FrameArena.h"
+#include "../Optional.h"
+#include <coroutine>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+
+namespace LinqPlusPlus
+{
+    namespace Coroutines
+    {
+        // The return type of a coroutine that produces a sequence with co_yield. The coroutine starts suspended and
+        // runs up to its next co_yield on each move_next. Its frame comes from the FrameArena.
+        template <typename T>
+        class Generator
+        {
+        public:
+            typedef T value_type;
+
+            struct promise_type
+            {
+                Optional<T> current;
+                std::exception_ptr error;
+
+                Generator get_return_object()
+                {
+                    return Generator(std::coroutine_handle<promise_type>::from_promise(*this));
+                }
+
+                std::suspend_always initial_suspend() noexcept
+                {
+                    return std::suspend_always();
+                }
+
+                std::suspend_always final_suspend() noexcept
+                {
+                    return std::suspend_always();
+                }
+
+                std::suspend_always yield_value(T value)
+                {
+                    current = Optional<T>(std::move(value));
+                    return std::suspend_always();
+                }
+
+                void return_void()
+                {
+                }
+
+                void unhandled_exception()
+                {
+                    error = std::current_exception();
+                }
+
+                static void* operator new(size_t size)
+                {
+                    return FrameArena::allocate(size);
+                }
+
+                static void operator delete(void* frame, size_t size)
+                {
+                    FrameArena::deallocate(frame, size);
+                }
+            };
+
+            Generator(Generator&& other) noexcept
+                : handle_(other.handle_)
+            {
+                other.handle_ = nullptr;
+            }
+
+            ~Generator()
+            {
+                if (handle_)
+                {
+                    handle_.destroy();
+                }
+            }
+
+            Generator& operator=(Generator&& rhs) noexcept
+            {
+                if (this != &rhs)
+                {
+                    if (handle_)
+                    {
+                        handle_.destroy();
+                    }
+
+                    handle_ = rhs.handle_;
+                    rhs.handle_ = nullptr;
+                }
+
+                return *this;
+            }
+
+            // Runs the coroutine up to its next co_yield, rethrowing anything it throws. Returns false once it has
+            // finished.
+            bool move_next()
+            {
+                if (!handle_ || handle_.done())
+                {
+                    return false;
+                }
+
+                handle_.resume();
+
+                promise_type& promise = handle_.promise();
+                if (promise.error != nullptr)
+                {
+                    std::exception_ptr error = promise.error;
+                    promise.error = nullptr;
+                    std::rethrow_exception(error);
+                }
+
+                return !handle_.done();
+            }
+
+            T& current_ref()
+            {
+                return *handle_.promise().current;
+            }
+
+        private:
+            Generator(const Generator&) = delete;
+            Generator& operator=(const Generator&) = delete;
+
+            explicit Generator(std::coroutine_handle<promise_type> handle)
+                : handle_(handle)
+            {
+            }
+
+            std::coroutine_handle<promise_type> handle_;
+        };
+    }
+}
+
+#endif
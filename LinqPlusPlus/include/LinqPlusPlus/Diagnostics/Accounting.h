@@ -0,0 +1,58 @@
+#ifndef LINQ_PLUSPLUS_ACCOUNTING_H
+#define LINQ_PLUSPLUS_ACCOUNTING_H
+
+#include <stdint.h>
+
+namespace LinqPlusPlus
+{
+    namespace Diagnostics
+    {
+        // Allocations made on the calling thread. These only move when the global allocation functions have been
+        // replaced by CountingAllocator.h (which LINQ_PLUSPLUS_INSTRUMENTATION builds do).
+        uint64_t allocations();
+        uint64_t allocated_bytes();
+        void record_allocation(uint64_t bytes);
+
+        // An element type that counts how often it is copied and moved on the calling thread.
+        class Tracked
+        {
+        public:
+            Tracked();
+            explicit Tracked(int value);
+            Tracked(const Tracked& other);
+            Tracked(Tracked&& other);
+            ~Tracked();
+
+            Tracked& operator=(const Tracked& rhs);
+            Tracked& operator=(Tracked&& rhs);
+
+            bool operator==(const Tracked& rhs) const { return value_ == rhs.value_; }
+            bool operator!=(const Tracked& rhs) const { return value_ != rhs.value_; }
+            bool operator<(const Tracked& rhs) const { return value_ < rhs.value_; }
+
+            int value() const { return value_; }
+
+            static uint64_t copies();
+            static uint64_t moves();
+
+        private:
+            int value_;
+        };
+
+        // A snapshot of the calling thread's allocation and copy counters; subtract two to get the cost of the work
+        // done in between.
+        struct Usage
+        {
+            static Usage now();
+
+            Usage operator-(const Usage& rhs) const;
+
+            uint64_t allocations;
+            uint64_t bytes;
+            uint64_t copies;
+            uint64_t moves;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef LINQ_PLUSPLUS_COUNTING_ALLOCATOR_H
+#define LINQ_PLUSPLUS_COUNTING_ALLOCATOR_H
+
+// Replaces the global allocation functions with ones that report every allocation to
+// Diagnostics::record_allocation. Include this in exactly one translation unit of a program; the library does so
+// itself when built with LINQ_PLUSPLUS_INSTRUMENTATION.
+
+#include "Accounting.h"
+#include <cstdlib>
+#include <new>
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+// The pairing is right (operator new allocates with malloc), but GCC checks it against the standard semantics.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size)
+{
+    LinqPlusPlus::Diagnostics::record_allocation(size);
+
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    return p;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+#endif
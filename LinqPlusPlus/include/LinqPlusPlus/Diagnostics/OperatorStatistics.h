@@ -0,0 +1,113 @@
+#ifndef LINQ_PLUSPLUS_OPERATOR_STATISTICS_H
+#define LINQ_PLUSPLUS_OPERATOR_STATISTICS_H
+
+#include "Accounting.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#ifndef LINQ_PLUSPLUS_INSTRUMENTATION_SAMPLE_PERIOD
+#define LINQ_PLUSPLUS_INSTRUMENTATION_SAMPLE_PERIOD 16
+#endif
+
+namespace LinqPlusPlus
+{
+    namespace Diagnostics
+    {
+        // Counters for a single operator in a query. Time and allocations are inclusive of the operator's inputs;
+        // the self_* accessors subtract the inputs out. Time is measured on every
+        // LINQ_PLUSPLUS_INSTRUMENTATION_SAMPLE_PERIOD-th call and scaled up to the total number of calls. Counters are
+        // shared by every enumerator over the same operator, so they're updated atomically.
+        class OperatorStatistics
+        {
+        public:
+            typedef std::shared_ptr<OperatorStatistics> Ptr;
+            typedef std::function<void(const OperatorStatistics&, size_t depth)> Visitor;
+
+            class Measurement
+            {
+            public:
+                explicit Measurement(OperatorStatistics& statistics)
+                    : statistics_(statistics)
+                    , timed_(statistics.calls_.fetch_add(1, std::memory_order_relaxed) % LINQ_PLUSPLUS_INSTRUMENTATION_SAMPLE_PERIOD == 0)
+                    , allocated_(allocated_bytes())
+                {
+                    if (timed_)
+                    {
+                        start_ = std::chrono::steady_clock::now();
+                    }
+                }
+
+                ~Measurement()
+                {
+                    if (timed_)
+                    {
+                        auto elapsed = std::chrono::steady_clock::now() - start_;
+                        statistics_.sampledNanoseconds_.fetch_add(
+                            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(), std::memory_order_relaxed);
+                        statistics_.sampledCalls_.fetch_add(1, std::memory_order_relaxed);
+                    }
+
+                    statistics_.bytesAllocated_.fetch_add(allocated_bytes() - allocated_, std::memory_order_relaxed);
+                }
+
+            private:
+                Measurement(const Measurement&);
+                Measurement& operator=(const Measurement&);
+
+                OperatorStatistics& statistics_;
+                bool timed_;
+                uint64_t allocated_;
+                std::chrono::steady_clock::time_point start_;
+            };
+
+            OperatorStatistics(const std::string& name, const std::vector<Ptr>& inputs);
+            OperatorStatistics(const OperatorStatistics&);
+            virtual ~OperatorStatistics();
+
+            OperatorStatistics& operator=(const OperatorStatistics&);
+
+            void record_move_next(bool moved)
+            {
+                moveNextCalls_.fetch_add(1, std::memory_order_relaxed);
+                if (moved)
+                {
+                    elementsOut_.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+
+            const std::string& name() const;
+            const std::vector<Ptr>& inputs() const;
+
+            uint64_t elements_in() const;
+            uint64_t elements_out() const;
+            uint64_t move_next_calls() const;
+            uint64_t nanoseconds() const;
+            uint64_t self_nanoseconds() const;
+            uint64_t bytes_allocated() const;
+            uint64_t self_bytes_allocated() const;
+
+            // Visits this operator and then its inputs, depth first.
+            void visit(const Visitor& visitor, size_t depth = 0) const;
+
+            // Renders the operator tree, one operator per line, inputs indented below their consumer.
+            std::string explain() const;
+
+        private:
+            std::string name_;
+            std::vector<Ptr> inputs_;
+            std::atomic<uint64_t> elementsOut_;
+            std::atomic<uint64_t> moveNextCalls_;
+            std::atomic<uint64_t> calls_;
+            std::atomic<uint64_t> sampledCalls_;
+            std::atomic<uint64_t> sampledNanoseconds_;
+            std::atomic<uint64_t> bytesAllocated_;
+        };
+    }
+}
+
+#endif
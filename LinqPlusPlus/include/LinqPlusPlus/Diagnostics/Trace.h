@@ -0,0 +1,82 @@
+#ifndef LINQ_PLUSPLUS_TRACE_H
+#define LINQ_PLUSPLUS_TRACE_H
+
+#include <atomic>
+#include <ostream>
+#include <stdint.h>
+#include <string>
+
+namespace LinqPlusPlus
+{
+    namespace Diagnostics
+    {
+        // Records timed spans (operators, batches, worker tasks) into a fixed-size ring buffer per thread and writes
+        // them out as Chrome trace event JSON, which chrome://tracing and Perfetto can load. Recording takes no
+        // locks; when a thread's buffer is full its oldest spans are overwritten. start() and stop() can be called
+        // while other threads are recording, and start() discards what the previous trace recorded; write() is meant
+        // to be called while no query is running.
+        class Trace
+        {
+        public:
+            static const uint32_t NoName = 0xFFFFFFFF;
+
+            static void start(size_t spansPerThread = 1 << 16);
+            static void stop();
+
+            static bool enabled()
+            {
+                return enabled_.load(std::memory_order_relaxed);
+            }
+
+            // Maps a span name to a small id so recording never has to copy strings.
+            static uint32_t intern(const std::string& name);
+
+            // Nanoseconds on the trace clock.
+            static uint64_t now();
+
+            static void record(const char* category, uint32_t name, uint64_t start, uint64_t end);
+
+            static void write(std::ostream& out);
+            static bool write(const std::string& path);
+
+        private:
+            static std::atomic<bool> enabled_;
+        };
+
+        class TraceScope
+        {
+        public:
+            TraceScope(const char* category, uint32_t name)
+                : category_(category)
+                , name_(name)
+                , start_(Trace::enabled() ? Trace::now() : 0)
+            {
+            }
+
+            TraceScope(const char* category, const std::string& name)
+                : category_(category)
+                , name_(Trace::enabled() ? Trace::intern(name) : Trace::NoName)
+                , start_(Trace::enabled() ? Trace::now() : 0)
+            {
+            }
+
+            ~TraceScope()
+            {
+                if (start_ != 0 && name_ != Trace::NoName && Trace::enabled())
+                {
+                    Trace::record(category_, name_, start_, Trace::now());
+                }
+            }
+
+        private:
+            TraceScope(const TraceScope&);
+            TraceScope& operator=(const TraceScope&);
+
+            const char* category_;
+            uint32_t name_;
+            uint64_t start_;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,301 @@
+#ifndef LINQ_PLUSPLUS_DICTIONARY_COLUMN_H
+#define LINQ_PLUSPLUS_DICTIONARY_COLUMN_H
+
+#include "IEnumerable.h"
+#include "Enumerators/ContainerEnumerator.h"
+#include "Enumerators/Deferred.h"
+#include "Enumerators/PositionEnumerator.h"
+#include "FlatMap.h"
+#include "Lookup.h"
+#include "Optional.h"
+#include <algorithm>
+#include <memory>
+#include <stddef.h>
+#include <stdexcept>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+namespace LinqPlusPlus
+{
+    // A dictionary encoded column, made by IEnumerable::dictionary_encode or Enumerable::from_dictionary: each
+    // distinct value is stored once in the dictionary, and each row as a dense 32 bit code indexing it. Enumerating
+    // the column decodes it, but distinct, contains, count_by, group_positions, where_equal, positions_of and join
+    // work on the codes, with bitmaps and arrays indexed by code instead of hashing and comparing values per row, and
+    // decode just the values in their results. Meant for low cardinality values, typically strings.
+    //
+    // distinct and contains answer through IEnumerable's hooks, so they keep working on the codes when the column is
+    // upcast to an ENUMERABLE_PTR(T), though not once other operators are chained onto it. The rest aren't reachable
+    // through the pointer and have to be written as where and the like over the decoded values.
+    template <typename T>
+    class DictionaryColumn: public IEnumerable<T>
+    {
+    public:
+        // The codes must index the dictionary, whose values must be distinct.
+        DictionaryColumn(std::vector<T>&& dictionary, std::vector<uint32_t>&& codes)
+            : dictionary_(std::make_shared<std::vector<T> >(std::move(dictionary)))
+            , index_(std::make_shared<FlatMap<T, uint32_t> >(dictionary_->size()))
+            , codes_(std::make_shared<std::vector<uint32_t> >(std::move(codes)))
+        {
+            for (size_t code = 0; code < dictionary_->size(); ++code)
+            {
+                if (!index_->insert((*dictionary_)[code], static_cast<uint32_t>(code)))
+                {
+                    throw std::runtime_error("Invalid argument: the dictionary has duplicate values");
+                }
+            }
+
+            for (uint32_t code : *codes_)
+            {
+                if (code >= dictionary_->size())
+                {
+                    throw std::out_of_range("A code is outside the dictionary");
+                }
+            }
+
+            make_decoder();
+        }
+
+        virtual ~DictionaryColumn(){}
+
+        virtual std::shared_ptr<Enumerator<T> > enumerator() const override
+        {
+            return source_->enumerator();
+        }
+
+#ifdef LINQ_PLUSPLUS_INSTRUMENTATION
+        virtual Diagnostics::OperatorStatistics::Ptr statistics() const override
+        {
+            return source_->statistics();
+        }
+#endif
+
+        const std::vector<T>& dictionary() const
+        {
+            return *dictionary_;
+        }
+
+        // The code of each row.
+        ENUMERABLE_PTR(uint32_t) codes() const
+        {
+            std::shared_ptr<std::vector<uint32_t> > codes = codes_;
+            return LinqPlusPlus::make_source<uint32_t>("codes", [=]()
+            {
+                return std::make_shared<Enumerators::ContainerEnumerator<uint32_t, std::vector<uint32_t> > >(codes);
+            });
+        }
+
+        Optional<uint32_t> code_of(const T& value) const
+        {
+            const uint32_t* code = index_->find(value);
+            return code != nullptr ? Optional<uint32_t>(*code) : Optional<uint32_t>();
+        }
+
+        // The number of rows holding each value, counted in an array indexed by code, in order of first appearance.
+        FlatMap<T, size_t> count_by() const
+        {
+            std::vector<size_t> counts(dictionary_->size());
+            std::vector<uint32_t> order;
+
+            for (uint32_t code : *codes_)
+            {
+                if (counts[code]++ == 0)
+                {
+                    order.push_back(code);
+                }
+            }
+
+            FlatMap<T, size_t> result(order.size());
+            for (uint32_t code : order)
+            {
+                result.insert((*dictionary_)[code], counts[code]);
+            }
+
+            return result;
+        }
+
+        // The positions of the rows holding each value, grouped in order of first appearance, for grouping the
+        // other columns of a table by this one.
+        Lookup<T, size_t> group_positions() const
+        {
+            const uint32_t none = UINT32_MAX;
+            std::vector<uint32_t> groupOfCode(dictionary_->size(), none);
+            FlatMap<T, size_t> groups;
+            std::vector<size_t> groupOf;
+            std::vector<size_t> positions;
+            groupOf.reserve(codes_->size());
+            positions.reserve(codes_->size());
+
+            for (size_t i = 0; i < codes_->size(); ++i)
+            {
+                uint32_t code = (*codes_)[i];
+                if (groupOfCode[code] == none)
+                {
+                    groupOfCode[code] = static_cast<uint32_t>(groups.size());
+                    groups.insert((*dictionary_)[code], groups.size());
+                }
+
+                groupOf.push_back(groupOfCode[code]);
+                positions.push_back(i);
+            }
+
+            return Lookup<T, size_t>(std::move(groups), groupOf, std::move(positions));
+        }
+
+        // The rows holding value, as a column sharing this one's dictionary. The rows are found by comparing codes.
+        std::shared_ptr<DictionaryColumn> where_equal(const T& value) const
+        {
+            std::shared_ptr<std::vector<uint32_t> > codes = std::make_shared<std::vector<uint32_t> >();
+
+            const uint32_t* code = index_->find(value);
+            if (code != nullptr)
+            {
+                codes->resize(std::count(codes_->begin(), codes_->end(), *code), *code);
+            }
+
+            return std::shared_ptr<DictionaryColumn>(new DictionaryColumn(dictionary_, index_, codes));
+        }
+
+        // The positions of the rows holding value.
+        std::vector<size_t> positions_of(const T& value) const
+        {
+            std::vector<size_t> positions;
+
+            const uint32_t* code = index_->find(value);
+            if (code != nullptr)
+            {
+                const uint32_t target = *code;
+                const uint32_t* codes = codes_->data();
+                for (size_t i = 0; i < codes_->size(); ++i)
+                {
+                    if (codes[i] == target)
+                    {
+                        positions.push_back(i);
+                    }
+                }
+            }
+
+            return positions;
+        }
+
+        // The pairs of positions of rows, here and in other, holding equal values, ordered by the position here and
+        // then there. The other dictionary is translated into this one's codes once, rather than per row, and the
+        // other rows are bucketed by code.
+        std::vector<std::pair<size_t, size_t> > join(const DictionaryColumn& other) const
+        {
+            const uint32_t none = UINT32_MAX;
+            std::vector<uint32_t> translated(other.dictionary_->size());
+            for (size_t code = 0; code < translated.size(); ++code)
+            {
+                const uint32_t* mine = index_->find((*other.dictionary_)[code]);
+                translated[code] = mine != nullptr ? *mine : none;
+            }
+
+            std::vector<size_t> offsets(dictionary_->size() + 1, 0);
+            for (uint32_t code : *other.codes_)
+            {
+                if (translated[code] != none)
+                {
+                    ++offsets[translated[code] + 1];
+                }
+            }
+
+            for (size_t code = 0; code < dictionary_->size(); ++code)
+            {
+                offsets[code + 1] += offsets[code];
+            }
+
+            std::vector<size_t> rows(offsets.back());
+            std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+            for (size_t j = 0; j < other.codes_->size(); ++j)
+            {
+                uint32_t code = translated[(*other.codes_)[j]];
+                if (code != none)
+                {
+                    rows[next[code]++] = j;
+                }
+            }
+
+            std::vector<std::pair<size_t, size_t> > pairs;
+            for (size_t i = 0; i < codes_->size(); ++i)
+            {
+                uint32_t code = (*codes_)[i];
+                for (size_t k = offsets[code]; k < offsets[code + 1]; ++k)
+                {
+                    pairs.push_back(std::pair<size_t, size_t>(i, rows[k]));
+                }
+            }
+
+            return pairs;
+        }
+
+    protected:
+        // Found with a bitmap of the codes seen.
+        virtual ENUMERABLE_PTR(T) distinct_values() const override
+        {
+            std::shared_ptr<std::vector<T> > dictionary = dictionary_;
+            std::shared_ptr<std::vector<uint32_t> > codes = codes_;
+
+            return LinqPlusPlus::make_source<T>("distinct", [=]()
+            {
+                return std::make_shared<Enumerators::Deferred<T> >([=]()
+                {
+                    std::vector<bool> seen(dictionary->size());
+                    std::shared_ptr<std::vector<uint32_t> > distinct = std::make_shared<std::vector<uint32_t> >();
+
+                    for (uint32_t code : *codes)
+                    {
+                        if (!seen[code])
+                        {
+                            seen[code] = true;
+                            distinct->push_back(code);
+                        }
+                    }
+
+                    return std::make_shared<Enumerators::PositionEnumerator<T, uint32_t> >(dictionary, distinct, 0, distinct->size());
+                }, false);
+            });
+        }
+
+        // At most one row, holding value's code, so contains compares codes rather than every decoded value.
+        virtual ENUMERABLE_PTR(T) candidates_equal_to(const T& value) const override
+        {
+            std::shared_ptr<std::vector<uint32_t> > codes = std::make_shared<std::vector<uint32_t> >();
+
+            Optional<uint32_t> code = code_of(value);
+            if (code && std::find(codes_->begin(), codes_->end(), *code) != codes_->end())
+            {
+                codes->push_back(*code);
+            }
+
+            return std::shared_ptr<DictionaryColumn>(new DictionaryColumn(dictionary_, index_, codes));
+        }
+
+    private:
+        DictionaryColumn(std::shared_ptr<std::vector<T> > dictionary, std::shared_ptr<FlatMap<T, uint32_t> > index,
+                         std::shared_ptr<std::vector<uint32_t> > codes)
+            : dictionary_(dictionary)
+            , index_(index)
+            , codes_(codes)
+        {
+            make_decoder();
+        }
+
+        void make_decoder()
+        {
+            std::shared_ptr<std::vector<T> > dictionary = dictionary_;
+            std::shared_ptr<std::vector<uint32_t> > codes = codes_;
+            source_ = LinqPlusPlus::make_source<T>("dictionary_encode", [=]()
+            {
+                return std::make_shared<Enumerators::PositionEnumerator<T, uint32_t> >(dictionary, codes, 0, codes->size());
+            });
+        }
+
+        std::shared_ptr<std::vector<T> > dictionary_;
+        std::shared_ptr<FlatMap<T, uint32_t> > index_;
+        std::shared_ptr<std::vector<uint32_t> > codes_;
+        ENUMERABLE_PTR(T) source_;
+    };
+}
+
+#endif
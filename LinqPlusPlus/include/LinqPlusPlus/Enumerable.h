@@ -2,14 +2,24 @@
 #define LINQ_PLUSPLUS_ENUMERABLE_H
 
 #include "IEnumerable.h"
+#include "Enumerators/AppendOnlyEnumerator.h"
+#include "Enumerators/ArithmeticSequence.h"
 #include "Enumerators/ArrayEnumerator.h"
 #include "Enumerators/ContainerEnumerator.h"
+#include "Enumerators/QueueEnumerator.h"
 #include "Enumerators/SequenceGenerator.h"
+#include <chrono>
 #include <deque>
 #include <list>
 #include <map>
+#include <memory>
+#include <utility>
 #include <vector>
 
+#if defined(__cpp_impl_coroutine)
+#include "Enumerators/GeneratorEnumerator.h"
+#endif
+
 namespace LinqPlusPlus
 {
     namespace Enumerable
@@ -17,15 +27,44 @@ namespace LinqPlusPlus
         template <typename T>
         ENUMERABLE_PTR(T) from_array(T* arr, size_t size)
         {
-            auto enumerator = std::shared_ptr<Enumerator<T> >(new Enumerators::ArrayEnumerator<T>(arr, size));
-            return ENUMERABLE_PTR(T)(new GenericEnumerable<T>(enumerator));
+            std::shared_ptr<Enumerators::ArrayEnumerator<T> > prototype(new Enumerators::ArrayEnumerator<T>(arr, size));
+            return make_source<T>("from_array", [=]()
+            {
+                return std::make_shared<Enumerators::ArrayEnumerator<T> >(*prototype);
+            });
+        }
+
+        // A column already dictionary encoded, for example read from a columnar file; see DictionaryColumn.
+        template <typename T>
+        std::shared_ptr<DictionaryColumn<T> > from_dictionary(std::vector<T> dictionary, std::vector<uint32_t> codes)
+        {
+            return std::make_shared<DictionaryColumn<T> >(std::move(dictionary), std::move(codes));
+        }
+
+        // Enumerates a container shared by every enumerator of the result.
+        template<typename T, typename Container>
+        ENUMERABLE_PTR(T) from(std::shared_ptr<Container> container)
+        {
+            return make_source<T>("from", [=]()
+            {
+                return std::make_shared<Enumerators::ContainerEnumerator<T, Container> >(container);
+            });
+        }
+
+        // For the overloads taking a container by rvalue: the result owns it, so consume() may move its elements out.
+        template<typename T, typename Container>
+        ENUMERABLE_PTR(T) from_owned(std::shared_ptr<Container> container)
+        {
+            return make_source<T>("from", [=]()
+            {
+                return std::make_shared<Enumerators::ContainerEnumerator<T, Container> >(container, true);
+            });
         }
 
         template<typename T, typename Container>
         ENUMERABLE_PTR(T) from(const Container& container)
         {
-            auto enumerator = std::shared_ptr<Enumerator<T> >(new Enumerators::ContainerEnumerator<T, Container>(container));
-            return ENUMERABLE_PTR(T)(new GenericEnumerable<T>(enumerator));
+            return from<T, Container>(std::make_shared<Container>(container));
         }
 
         template <typename T>
@@ -34,12 +73,25 @@ namespace LinqPlusPlus
             return from<T, std::deque<T> >(container);
         }
 
+        // Takes ownership of the container instead of copying it, so move-only element types can be enumerated.
+        template <typename T>
+        ENUMERABLE_PTR(T) from(std::deque<T>&& container)
+        {
+            return from_owned<T, std::deque<T> >(std::make_shared<std::deque<T> >(std::move(container)));
+        }
+
         template <typename T>
         ENUMERABLE_PTR(T) from(const std::list<T>& container)
         {
             return from<T, std::list<T> >(container);
         }
 
+        template <typename T>
+        ENUMERABLE_PTR(T) from(std::list<T>&& container)
+        {
+            return from_owned<T, std::list<T> >(std::make_shared<std::list<T> >(std::move(container)));
+        }
+
         template <typename Key, typename T>
         std::shared_ptr<IEnumerable<std::pair<Key, T> > > from(const std::map<Key, T>& container)
         {
@@ -52,22 +104,106 @@ namespace LinqPlusPlus
             return from<T, std::vector<T> >(container);
         }
 
+        template <typename T>
+        ENUMERABLE_PTR(T) from(std::vector<T>&& container)
+        {
+            return from_owned<T, std::vector<T> >(std::make_shared<std::vector<T> >(std::move(container)));
+        }
+
+        // Enumerates a vector that is only ever appended to, seeing whatever it holds at the time. Enumerators that
+        // have reached the end carry on with any elements appended later, for incremental_aggregate. Don't append
+        // while the vector is being enumerated.
+        template <typename T>
+        ENUMERABLE_PTR(T) from_append_only(std::shared_ptr<std::vector<T> > container)
+        {
+            return make_source<T>("from_append_only", [=]()
+            {
+                return std::make_shared<Enumerators::AppendOnlyEnumerator<T, std::vector<T> > >(container);
+            });
+        }
+
+        template <typename T>
+        ENUMERABLE_PTR(T) from_append_only(std::shared_ptr<std::deque<T> > container)
+        {
+            return make_source<T>("from_append_only", [=]()
+            {
+                return std::make_shared<Enumerators::AppendOnlyEnumerator<T, std::deque<T> > >(container);
+            });
+        }
+
+#if defined(__cpp_impl_coroutine)
+        // Enumerates what the coroutine co_yields; each enumeration calls it to start a new coroutine.
+        template <typename T>
+        ENUMERABLE_PTR(T) from_generator(std::function<Coroutines::Generator<T> ()> coroutine)
+        {
+            return make_source<T>("from_generator", [=]()
+            {
+                return std::make_shared<Enumerators::GeneratorEnumerator<T, Coroutines::Generator<T> > >(coroutine);
+            });
+        }
+
+        // As above, for a coroutine that also co_awaits; move_next blocks while it is suspended on anything but
+        // a co_yield. Coroutines that need to consume it without blocking co_await AsyncGenerator::move_next.
+        template <typename T>
+        ENUMERABLE_PTR(T) from_generator(std::function<Coroutines::AsyncGenerator<T> ()> coroutine)
+        {
+            return make_source<T>("from_generator", [=]()
+            {
+                return std::make_shared<Enumerators::GeneratorEnumerator<T, Coroutines::AsyncGenerator<T> > >(coroutine);
+            });
+        }
+#endif
+
+        // Enumerates elements as they are pushed onto the queue, until it is closed. Every enumeration takes elements
+        // off the queue, so a query over a live stream is normally enumerated once, by one consumer per thread.
+        template <typename T>
+        ENUMERABLE_PTR(T) from_queue(std::shared_ptr<Concurrency::BoundedQueue<T> > queue, Enumerators::QueueWait wait = Enumerators::QueueWait::Block)
+        {
+            return make_source<T>("from_queue", [=]()
+            {
+                return std::make_shared<Enumerators::QueueEnumerator<T> >(queue, wait, std::chrono::nanoseconds::zero());
+            });
+        }
+
+        // As from_queue, but each enumeration also ends once no element has arrived for the given timeout.
+        template <typename T, typename Rep, typename Period>
+        ENUMERABLE_PTR(T) from_queue(std::shared_ptr<Concurrency::BoundedQueue<T> > queue, std::chrono::duration<Rep, Period> timeout)
+        {
+            std::chrono::nanoseconds wait = std::chrono::duration_cast<std::chrono::nanoseconds>(timeout);
+            return make_source<T>("from_queue", [=]()
+            {
+                return std::make_shared<Enumerators::QueueEnumerator<T> >(queue, Enumerators::QueueWait::Timeout, wait);
+            });
+        }
+
         template <typename T>
         ENUMERABLE_PTR(T) empty()
         {
             return from<T>(std::vector<T>());
         }
 
+        template <typename T>
+        ENUMERABLE_PTR(T) range(T start, size_t count)
+        {
+            return make_source<T>("range", [=]()
+            {
+                return std::make_shared<Enumerators::ArithmeticSequence<T> >(start, T(1), count);
+            });
+        }
+
         template <int Start, int Count>
         ENUMERABLE_PTR(int) range()
         {
-            auto enumerator = std::shared_ptr<Enumerator<int> >(
-                new Enumerators::SequenceGenerator<int>(
-                    Start - 1,
-                    [](const int& n){ return n + 1; },
-                    [](const int& n){ return (n + 1) >= (Start + Count); }));
+            return range<int>(Start, Count > 0 ? Count : 0);
+        }
 
-            return ENUMERABLE_PTR(int)(new GenericEnumerable<int>(enumerator));
+        template <typename T>
+        ENUMERABLE_PTR(T) sequence(T start, T step, size_t count)
+        {
+            return make_source<T>("sequence", [=]()
+            {
+                return std::make_shared<Enumerators::ArithmeticSequence<T> >(start, step, count);
+            });
         }
     }
 }
@@ -0,0 +1,95 @@
+#ifndef LINQ_PLUSPLUS_APPEND_ONLY_ENUMERATOR_H
+#define LINQ_PLUSPLUS_APPEND_ONLY_ENUMERATOR_H
+
+#include "Enumerator.h"
+#include <assert.h>
+#include <functional>
+#include <memory>
+
+namespace LinqPlusPlus
+{
+    namespace Enumerators
+    {
+        // Enumerates a vector or deque that is only ever appended to, by position rather than by iterator. Once it
+        // reaches the end it can be moved on again after more elements are appended, and it picks up from the first
+        // of them, which is what lets an incremental aggregate fold in only what's new.
+        template <typename T, typename Container>
+        class AppendOnlyEnumerator: public Enumerator<T>
+        {
+        public:
+            explicit AppendOnlyEnumerator(std::shared_ptr<Container> container)
+                : container_(container)
+                , next_(0)
+            {
+            }
+
+            AppendOnlyEnumerator(const AppendOnlyEnumerator& other)
+                : container_(other.container_)
+                , next_(other.next_)
+            {
+            }
+
+            virtual ~AppendOnlyEnumerator(){}
+
+            AppendOnlyEnumerator& operator=(const AppendOnlyEnumerator& rhs)
+            {
+                container_ = rhs.container_;
+                next_ = rhs.next_;
+
+                return *this;
+            }
+
+            virtual T& current_ref() override
+            {
+                assert(next_ > 0);
+                return (*container_)[next_ - 1];
+            }
+
+            virtual T current() const override
+            {
+                assert(next_ > 0);
+                return copy_value((*container_)[next_ - 1]);
+            }
+
+            virtual bool move_next() override
+            {
+                if (next_ >= container_->size())
+                {
+                    return false;
+                }
+
+                ++next_;
+                return true;
+            }
+
+            virtual bool resumable() const override
+            {
+                return true;
+            }
+
+            virtual void reset() override
+            {
+                next_ = 0;
+            }
+
+            virtual bool push(const std::function<bool(T&)>& sink) override
+            {
+                for (size_t size = container_->size(); next_ < size; )
+                {
+                    if (!sink((*container_)[next_++]))
+                    {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+        private:
+            std::shared_ptr<Container> container_;
+            size_t next_;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef LINQ_PLUSPLUS_ARITHMETIC_SEQUENCE_H
+#define LINQ_PLUSPLUS_ARITHMETIC_SEQUENCE_H
+
+#include "Enumerator.h"
+#include "RandomAccess.h"
+#include <assert.h>
+#include <stdint.h>
+#include <type_traits>
+
+namespace LinqPlusPlus
+{
+    namespace Enumerators
+    {
+        // start, start + step, ..., start + (count - 1) * step. Each element is computed from its index rather than
+        // accumulated, so floating point sequences don't drift and any element can be reached in O(1).
+        template <typename T>
+        class ArithmeticSequence: public Enumerator<T>, public RandomAccess
+        {
+        public:
+            ArithmeticSequence(const T& start, const T& step, size_t count)
+                : start_(start)
+                , step_(step)
+                , count_(count)
+                , index_(count)
+                , current_(start)
+                , isReset_(true)
+            {
+            }
+
+            ArithmeticSequence(const ArithmeticSequence& other)
+                : start_(other.start_)
+                , step_(other.step_)
+                , count_(other.count_)
+                , index_(other.index_)
+                , current_(other.current_)
+                , isReset_(other.isReset_)
+            {
+            }
+
+            virtual ~ArithmeticSequence(){}
+
+            ArithmeticSequence& operator=(const ArithmeticSequence& rhs)
+            {
+                start_ = rhs.start_;
+                step_ = rhs.step_;
+                count_ = rhs.count_;
+                index_ = rhs.index_;
+                current_ = rhs.current_;
+                isReset_ = rhs.isReset_;
+
+                return *this;
+            }
+
+            // The sum of the whole sequence in closed form. For integral types the arithmetic wraps the same way
+            // adding the elements one at a time would.
+            T sum() const
+            {
+                return sum(std::is_integral<T>());
+            }
+
+            virtual T& current_ref() override
+            {
+                assert(!isReset_ && index_ < count_);
+                return current_;
+            }
+
+            virtual T current() const override
+            {
+                assert(!isReset_ && index_ < count_);
+                return current_;
+            }
+
+            virtual bool move_next() override
+            {
+                return seek(isReset_ ? 0 : index_ + 1);
+            }
+
+            virtual void reset() override
+            {
+                isReset_ = true;
+                index_ = count_;
+            }
+
+            virtual bool push(const std::function<bool(T&)>& sink) override
+            {
+                size_t i = isReset_ ? 0 : (index_ < count_ ? index_ + 1 : count_);
+                isReset_ = false;
+
+                for (; i < count_; ++i)
+                {
+                    current_ = static_cast<T>(start_ + step_ * static_cast<T>(i));
+
+                    if (!sink(current_))
+                    {
+                        index_ = i;
+                        return false;
+                    }
+                }
+
+                index_ = count_;
+                return true;
+            }
+
+            virtual RandomAccess* random_access() override
+            {
+                return this;
+            }
+
+            virtual size_t size() const override
+            {
+                return count_;
+            }
+
+            virtual bool seek(size_t index) override
+            {
+                isReset_ = false;
+
+                if (index >= count_)
+                {
+                    index_ = count_;
+                    return false;
+                }
+
+                index_ = index;
+                current_ = static_cast<T>(start_ + step_ * static_cast<T>(index));
+                return true;
+            }
+
+        private:
+            T sum(std::true_type) const
+            {
+                // count * start + step * count * (count - 1) / 2, halving whichever of count and count - 1 is even
+                // so the division stays exact under wrapping.
+                uint64_t count = count_;
+                uint64_t triangle = count % 2 == 0 ? (count / 2) * (count - 1) : count * ((count - 1) / 2);
+
+                return static_cast<T>(static_cast<uint64_t>(start_) * count + static_cast<uint64_t>(step_) * triangle);
+            }
+
+            T sum(std::false_type) const
+            {
+                double count = static_cast<double>(count_);
+                return static_cast<T>(start_ * count + step_ * (count * (count - 1) / 2));
+            }
+
+            T start_;
+            T step_;
+            size_t count_;
+            size_t index_;
+            T current_;
+            bool isReset_;
+        };
+    }
+}
+
+#endif
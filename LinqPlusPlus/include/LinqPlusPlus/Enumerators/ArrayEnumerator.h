@@ -2,60 +2,47 @@
 #define LINQ_PLUSPLUS_ARRAY_ENUMERATOR_H
 
 #include "Enumerator.h"
+#include "RandomAccess.h"
 #include <algorithm>
 #include <assert.h>
-#include <string.h>
+#include <memory>
 
 namespace LinqPlusPlus
 {
     namespace Enumerators
     {
+        // Copies the array once; copies of the enumerator share that copy, so each can enumerate it independently.
         template <typename T>
-        class ArrayEnumerator: public Enumerator<T>
+        class ArrayEnumerator: public Enumerator<T>, public RandomAccess
         {
         public:
             ArrayEnumerator(T* arr, size_t size)
-                : arr_(nullptr)
+                : arr_(new T[size], std::default_delete<T[]>())
                 , size_(size)
                 , current_(size_)
                 , isReset_(true)
             {
-                arr_ = new T[size_];
-                memcpy(arr_, arr, size_ * sizeof(T));
+                std::copy(arr, arr + size, arr_.get());
             }
 
             ArrayEnumerator(const ArrayEnumerator& other)
-                : size_(other.size_)
+                : arr_(other.arr_)
+                , size_(other.size_)
                 , current_(other.current_)
                 , isReset_(other.isReset_)
             {
-                if (this != &other)
-                {
-                    delete[] arr_;
-                    arr_ = new T[size_];
-                    memcpy(arr_, other.arr_, size_ * sizeof(T));
-                }
             }
 
             virtual ~ArrayEnumerator()
             {
-                delete[] arr_;
-                arr_ = nullptr;
-                size_ = 0;
             }
 
             ArrayEnumerator& operator=(const ArrayEnumerator& rhs)
             {
-                if (this != &rhs)
-                {
-                    delete[] arr_;
-                    arr_ = new T[size_];
-                    memcpy(arr_, rhs.arr_, rhs.size_ * sizeof(T));
-
-                    size_ = rhs.size_;
-                    current_ = rhs.current_;
-                    isReset_ = rhs.isReset_;
-                }
+                arr_ = rhs.arr_;
+                size_ = rhs.size_;
+                current_ = rhs.current_;
+                isReset_ = rhs.isReset_;
 
                 return *this;
             }
@@ -63,13 +50,13 @@ namespace LinqPlusPlus
             T& current_ref() override
             {
                 assert(!isReset_);
-                return arr_[current_];
+                return arr_.get()[current_];
             }
 
             T current() const override
             {
                 assert(!isReset_);
-                return arr_[current_];
+                return arr_.get()[current_];
             }
 
             virtual bool can_move_next() const
@@ -100,8 +87,54 @@ namespace LinqPlusPlus
                 current_ = size_;
             }
 
+            virtual bool push(const std::function<bool(T&)>& sink) override
+            {
+                T* arr = arr_.get();
+                size_t i = isReset_ ? 0 : (current_ < size_ ? current_ + 1 : size_);
+                isReset_ = false;
+
+                for (; i < size_; ++i)
+                {
+                    if (!sink(arr[i]))
+                    {
+                        current_ = i;
+                        return false;
+                    }
+                }
+
+                current_ = size_;
+                return true;
+            }
+
+            virtual bool push_blocks(const std::function<bool(T*, size_t)>& sink) override
+            {
+                size_t i = isReset_ ? 0 : (current_ < size_ ? current_ + 1 : size_);
+                isReset_ = false;
+                current_ = size_;
+
+                return i == size_ || sink(arr_.get() + i, size_ - i);
+            }
+
+            virtual RandomAccess* random_access() override
+            {
+                return this;
+            }
+
+            virtual size_t size() const override
+            {
+                return size_;
+            }
+
+            virtual bool seek(size_t index) override
+            {
+                isReset_ = false;
+                current_ = index < size_ ? index : size_;
+
+                return current_ < size_;
+            }
+
         private:
-            T* arr_;
+            std::shared_ptr<T> arr_;
             size_t size_;
             size_t current_;
             bool isReset_;
@@ -0,0 +1,204 @@
+#ifndef LINQ_PLUSPLUS_ASYNC_BOUNDARY_H
+#define LINQ_PLUSPLUS_ASYNC_BOUNDARY_H
+
+#include "Enumerator.h"
+#include "../Concurrency/Backoff.h"
+#include "../Concurrency/SpscRing.h"
+#include "../Diagnostics/Trace.h"
+#include "../Optional.h"
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <thread>
+
+namespace LinqPlusPlus
+{
+    namespace Enumerators
+    {
+        // Enumerates the source on a worker thread, started by the first move_next, which runs ahead of the
+        // consumer by at most capacity elements. Elements are handed over through an SpscRing; exceptions thrown
+        // by the source are rethrown by move_next. Resetting or destroying the enumerator stops the worker. The
+        // elements are moved across if consuming, and copied otherwise.
+        template <typename T>
+        class AsyncBoundary: public Enumerator<T>
+        {
+        public:
+            AsyncBoundary(std::shared_ptr<Enumerator<T> > source, size_t capacity, bool consuming)
+                : source_(source)
+                , capacity_(capacity)
+                , consuming_(consuming)
+                , ring_()
+                , worker_()
+                , done_(false)
+                , cancelled_(false)
+                , error_()
+                , current_()
+            {
+            }
+
+            AsyncBoundary(const AsyncBoundary& other)
+                : source_(other.source_)
+                , capacity_(other.capacity_)
+                , consuming_(other.consuming_)
+                , ring_()
+                , worker_()
+                , done_(false)
+                , cancelled_(false)
+                , error_()
+                , current_()
+            {
+            }
+
+            virtual ~AsyncBoundary()
+            {
+                stop();
+            }
+
+            AsyncBoundary& operator=(const AsyncBoundary& rhs)
+            {
+                stop();
+                source_ = rhs.source_;
+                capacity_ = rhs.capacity_;
+                consuming_ = rhs.consuming_;
+                ring_.reset();
+                current_.reset();
+                return *this;
+            }
+
+            virtual T& current_ref() override
+            {
+                return *current_;
+            }
+
+            virtual T current() const override
+            {
+                return copy_value(*current_);
+            }
+
+            virtual bool move_next() override
+            {
+                if (ring_ == nullptr)
+                {
+                    ring_.reset(new Concurrency::SpscRing<T>(capacity_));
+                }
+
+                if (!worker_.joinable())
+                {
+                    if (done_.load(std::memory_order_acquire))
+                    {
+                        current_.reset();
+                        return false;
+                    }
+
+                    worker_ = std::thread(&AsyncBoundary::produce, this);
+                }
+
+                Concurrency::Backoff backoff;
+
+                while (!ring_->try_pop(current_))
+                {
+                    if (done_.load(std::memory_order_acquire))
+                    {
+                        // The worker may have pushed its last elements just before finishing.
+                        if (ring_->try_pop(current_))
+                        {
+                            return true;
+                        }
+
+                        worker_.join();
+                        current_.reset();
+
+                        if (error_ != nullptr)
+                        {
+                            std::exception_ptr error = error_;
+                            error_ = nullptr;
+                            std::rethrow_exception(error);
+                        }
+
+                        return false;
+                    }
+
+                    backoff.wait();
+                }
+
+                return true;
+            }
+
+            virtual bool movable() const override
+            {
+                return true;
+            }
+
+            virtual void reset() override
+            {
+                stop();
+                source_->reset();
+                current_.reset();
+            }
+
+        private:
+            void produce()
+            {
+                Diagnostics::TraceScope span("worker", "async_boundary");
+                Concurrency::Backoff backoff;
+
+                try
+                {
+                    while (!cancelled_.load(std::memory_order_relaxed) && source_->move_next())
+                    {
+                        T& element = source_->current_ref();
+                        T value(consuming_ ? std::move(element) : copy_value(element));
+
+                        while (!ring_->try_push(std::move(value)))
+                        {
+                            if (cancelled_.load(std::memory_order_relaxed))
+                            {
+                                break;
+                            }
+
+                            backoff.wait();
+                        }
+
+                        backoff.reset();
+                    }
+                }
+                catch (...)
+                {
+                    error_ = std::current_exception();
+                }
+
+                done_.store(true, std::memory_order_release);
+            }
+
+            void stop()
+            {
+                if (worker_.joinable())
+                {
+                    cancelled_.store(true, std::memory_order_relaxed);
+                    worker_.join();
+                }
+
+                if (ring_ != nullptr)
+                {
+                    ring_->clear();
+                }
+
+                done_.store(false, std::memory_order_relaxed);
+                cancelled_.store(false, std::memory_order_relaxed);
+                error_ = nullptr;
+            }
+
+            std::shared_ptr<Enumerator<T> > source_;
+            size_t capacity_;
+            bool consuming_;
+            std::unique_ptr<Concurrency::SpscRing<T> > ring_;
+            std::thread worker_;
+            std::atomic<bool> done_;
+            std::atomic<bool> cancelled_;
+            std::exception_ptr error_;
+            Optional<T> current_;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef LINQ_PLUSPLUS_BERNOULLI_SAMPLE_H
+#define LINQ_PLUSPLUS_BERNOULLI_SAMPLE_H
+
+#include "Enumerator.h"
+#include "RandomAccess.h"
+#include "SampleRandom.h"
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <stdint.h>
+
+namespace LinqPlusPlus
+{
+    namespace Enumerators
+    {
+        // Keeps each element of the source with the given probability. Rather than drawing a number per element it
+        // draws the geometrically distributed gap to the next kept one, which a random access source jumps with a
+        // single seek.
+        template <typename T>
+        class BernoulliSample: public Enumerator<T>
+        {
+        public:
+            BernoulliSample(std::shared_ptr<Enumerator<T> > source, RandomAccess* random, double probability, uint64_t seed)
+                : source_(source)
+                , random_(random)
+                , logFailure_(std::log1p(-probability))
+                , seed_(seed)
+                , generator_(seed)
+                , position_(0)
+            {
+            }
+
+            BernoulliSample(const BernoulliSample& other)
+                : source_(other.source_)
+                , random_(other.random_)
+                , logFailure_(other.logFailure_)
+                , seed_(other.seed_)
+                , generator_(other.generator_)
+                , position_(other.position_)
+            {
+            }
+
+            virtual ~BernoulliSample(){}
+
+            BernoulliSample& operator=(const BernoulliSample& rhs)
+            {
+                source_ = rhs.source_;
+                random_ = rhs.random_;
+                logFailure_ = rhs.logFailure_;
+                seed_ = rhs.seed_;
+                generator_ = rhs.generator_;
+                position_ = rhs.position_;
+
+                return *this;
+            }
+
+            virtual T& current_ref() override
+            {
+                return source_->current_ref();
+            }
+
+            virtual T current() const override
+            {
+                return source_->current();
+            }
+
+            virtual bool move_next() override
+            {
+                size_t skip = generator_.skip(logFailure_);
+
+                if (random_ != nullptr)
+                {
+                    return seek_after(skip);
+                }
+
+                for (; skip > 0; --skip)
+                {
+                    if (!source_->move_next())
+                    {
+                        return false;
+                    }
+                }
+
+                return source_->move_next();
+            }
+
+            virtual bool movable() const override
+            {
+                return source_->movable();
+            }
+
+            virtual void reset() override
+            {
+                source_->reset();
+                generator_ = SampleRandom(seed_);
+                position_ = 0;
+            }
+
+            virtual bool push(const std::function<bool(T&)>& sink) override
+            {
+                if (random_ != nullptr)
+                {
+                    while (seek_after(generator_.skip(logFailure_)))
+                    {
+                        if (!sink(source_->current_ref()))
+                        {
+                            return false;
+                        }
+                    }
+
+                    return true;
+                }
+
+                size_t skip = generator_.skip(logFailure_);
+                return source_->push([&](T& t)
+                {
+                    if (skip > 0)
+                    {
+                        --skip;
+                        return true;
+                    }
+
+                    if (!sink(t))
+                    {
+                        return false;
+                    }
+
+                    skip = generator_.skip(logFailure_);
+                    return true;
+                });
+            }
+
+        private:
+            bool seek_after(size_t skip)
+            {
+                size_t size = random_->size();
+                if (position_ >= size || skip >= size - position_)
+                {
+                    position_ = size;
+                    return false;
+                }
+
+                position_ += skip;
+                return random_->seek(position_++);
+            }
+
+            std::shared_ptr<Enumerator<T> > source_;
+            RandomAccess* random_;
+            double logFailure_;
+            uint64_t seed_;
+            SampleRandom generator_;
+            size_t position_;
+        };
+    }
+}
+
+#endif
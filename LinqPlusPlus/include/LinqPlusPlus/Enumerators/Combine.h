@@ -3,6 +3,7 @@
 
 #include "Enumerator.h"
 #include <assert.h>
+#include <memory>
 
 namespace LinqPlusPlus
 {
@@ -12,7 +13,7 @@ namespace LinqPlusPlus
         class Combine: public Enumerator<T>
         {
         public:
-            Combine(Enumerator<T>& first, Enumerator<T>& second)
+            Combine(std::shared_ptr<Enumerator<T> > first, std::shared_ptr<Enumerator<T> > second)
                 : first_(first)
                 , second_(second)
                 , active_(nullptr)
@@ -49,15 +50,15 @@ namespace LinqPlusPlus
 
             virtual bool move_next() override
             {
-                if(first_.move_next())
+                if(first_->move_next())
                 {
-                    active_ = &first_;
+                    active_ = first_.get();
                     return true;
                 }
                 
-                if (second_.move_next())
+                if (second_->move_next())
                 {
-                    active_ = &second_;
+                    active_ = second_.get();
                     return true;
                 }
 
@@ -65,15 +66,25 @@ namespace LinqPlusPlus
                 return false;
             }
 
+            virtual bool movable() const override
+            {
+                return first_->movable() && second_->movable();
+            }
+
             virtual void reset() override
             {
-                first_.reset();
-                second_.reset();
+                first_->reset();
+                second_->reset();
+            }
+
+            virtual bool push(const std::function<bool(T&)>& sink) override
+            {
+                return first_->push(sink) && second_->push(sink);
             }
 
         private:
-            Enumerator<T>& first_;
-            Enumerator<T>& second_;
+            std::shared_ptr<Enumerator<T> > first_;
+            std::shared_ptr<Enumerator<T> > second_;
             Enumerator<T>* active_;
         };
     }
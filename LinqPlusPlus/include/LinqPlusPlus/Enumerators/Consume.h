@@ -0,0 +1,87 @@
+#ifndef LINQ_PLUSPLUS_CONSUME_H
+#define LINQ_PLUSPLUS_CONSUME_H
+
+#include "Enumerator.h"
+#include <memory>
+
+namespace LinqPlusPlus
+{
+    namespace Enumerators
+    {
+        // Marks a query whose elements may be moved out by the terminal operator that follows it, rather than
+        // copied, if the source says they are movable. The enumerators upstream are left holding moved-from values,
+        // so a consumed query should not be enumerated again.
+        template <typename T>
+        class Consume: public Enumerator<T>
+        {
+        public:
+            explicit Consume(std::shared_ptr<Enumerator<T> > source)
+                : source_(source)
+            {
+            }
+
+            Consume(const Consume& other)
+                : source_(other.source_)
+            {
+            }
+
+            virtual ~Consume(){}
+
+            Consume& operator=(const Consume& rhs)
+            {
+                source_ = rhs.source_;
+                return *this;
+            }
+
+            Enumerator<T>& source() const
+            {
+                return *source_;
+            }
+
+            virtual T& current_ref() override
+            {
+                return source_->current_ref();
+            }
+
+            virtual T current() const override
+            {
+                return source_->current();
+            }
+
+            virtual bool move_next() override
+            {
+                return source_->move_next();
+            }
+
+            virtual bool movable() const override
+            {
+                return source_->movable();
+            }
+
+            virtual bool resumable() const override
+            {
+                return source_->resumable();
+            }
+
+            virtual void reset() override
+            {
+                source_->reset();
+            }
+
+            virtual RandomAccess* random_access() override
+            {
+                return source_->random_access();
+            }
+
+            virtual bool push(const std::function<bool(T&)>& sink) override
+            {
+                return source_->push(sink);
+            }
+
+        private:
+            std::shared_ptr<Enumerator<T> > source_;
+        };
+    }
+}
+
+#endif
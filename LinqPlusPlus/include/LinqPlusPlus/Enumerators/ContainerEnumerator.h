@@ -2,23 +2,49 @@
 #define LINQ_PLUSPLUS_CONTAINER_ENUMERATOR_H
 
 #include "Enumerator.h"
+#include "RandomAccess.h"
 #include <assert.h>
+#include <iterator>
 #include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace LinqPlusPlus
 {
     namespace Enumerators
     {
         template < typename T, typename Container >
-        class ContainerEnumerator : public Enumerator<T>
+        class ContainerEnumerator : public Enumerator<T>, public RandomAccess
         {
         public:
             explicit ContainerEnumerator(const Container& container)
+                : Enumerator<T>()
+                , container_(new Container(container))
+                , isReset_(true)
+                , movable_(true)
+            {
+                current_ = container_->end();
+            }
+
+            explicit ContainerEnumerator(Container&& container)
+                : Enumerator<T>()
+                , container_(new Container(std::move(container)))
+                , isReset_(true)
+                , movable_(true)
+            {
+                current_ = container_->end();
+            }
+
+            // Enumerators created over the same container share it rather than copying it. Its elements are only
+            // moved out by consume() if it is movable, i.e. nothing but the query holds it.
+            explicit ContainerEnumerator(std::shared_ptr<Container> container, bool movable = false)
                 : Enumerator<T>()
                 , container_(container)
                 , isReset_(true)
+                , movable_(movable)
             {
-                current_ = container_.end();
+                current_ = container_->end();
             }
 
             ContainerEnumerator(const ContainerEnumerator& other)
@@ -26,6 +52,7 @@ namespace LinqPlusPlus
                 , container_(other.container_)
                 , current_(other.current_)
                 , isReset_(other.isReset_)
+                , movable_(other.movable_)
             {
             }
 
@@ -36,6 +63,7 @@ namespace LinqPlusPlus
                 container_ = rhs.container_;
                 current_ = rhs.current_;
                 isReset_ = rhs.isReset_;
+                movable_ = rhs.movable_;
 
                 return *this;
             }
@@ -61,12 +89,12 @@ namespace LinqPlusPlus
             virtual T current() const override
             {
                 assert(!isReset_);
-                return *current_;
+                return copy_value(*current_);
             }
 
             virtual bool can_move_next() const
             {
-                return container_.begin() != container_.end() && (isReset_ || current_ != container_.end());
+                return container_->begin() != container_->end() && (isReset_ || current_ != container_->end());
             }
 
             virtual bool move_next() override
@@ -78,24 +106,90 @@ namespace LinqPlusPlus
 
                 if (isReset_)
                 {
-                    current_ = container_.begin();
+                    current_ = container_->begin();
                     isReset_ = false;
                     return true;
                 }
 
-                return ++current_ != container_.end();
+                return ++current_ != container_->end();
             }
 
             virtual void reset() override
             {
                 isReset_ = true;
-                current_ = container_.end();
+                current_ = container_->end();
+            }
+
+            virtual bool movable() const override
+            {
+                return movable_;
+            }
+
+            virtual bool push(const std::function<bool(T&)>& sink) override
+            {
+                typename Container::iterator end = container_->end();
+                typename Container::iterator it = isReset_ ? container_->begin() : (current_ == end ? end : std::next(current_));
+                isReset_ = false;
+
+                for (; it != end; ++it)
+                {
+                    if (!sink(*it))
+                    {
+                        current_ = it;
+                        return false;
+                    }
+                }
+
+                current_ = end;
+                return true;
+            }
+
+            virtual bool push_blocks(const std::function<bool(T*, size_t)>& sink) override
+            {
+                return push_blocks(sink, std::is_same<Container, std::vector<T> >());
+            }
+
+            // Only containers with random access iterators can seek in constant time; for the others, such as lists,
+            // sets and maps, operators fall back to enumerating.
+            virtual RandomAccess* random_access() override
+            {
+                typedef typename std::iterator_traits<typename Container::iterator>::iterator_category Category;
+                return std::is_base_of<std::random_access_iterator_tag, Category>::value ? this : nullptr;
+            }
+
+            virtual size_t size() const override
+            {
+                return container_->size();
+            }
+
+            virtual bool seek(size_t index) override
+            {
+                isReset_ = false;
+                current_ = index < container_->size() ? std::next(container_->begin(), index) : container_->end();
+
+                return current_ != container_->end();
             }
 
         private:
-            Container container_;
+            bool push_blocks(const std::function<bool(T*, size_t)>& sink, std::true_type)
+            {
+                size_t size = container_->size();
+                size_t i = isReset_ ? 0 : (current_ == container_->end() ? size : static_cast<size_t>(current_ - container_->begin()) + 1);
+                isReset_ = false;
+                current_ = container_->end();
+
+                return i == size || sink(container_->data() + i, size - i);
+            }
+
+            bool push_blocks(const std::function<bool(T*, size_t)>& sink, std::false_type)
+            {
+                return Enumerator<T>::push_blocks(sink);
+            }
+
+            std::shared_ptr<Container> container_;
             typename Container::iterator current_;
             bool isReset_;
+            bool movable_;
         };
     }
 }
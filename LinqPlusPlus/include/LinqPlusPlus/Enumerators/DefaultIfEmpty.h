@@ -0,0 +1,114 @@
+#ifndef LINQ_PLUSPLUS_DEFAULT_IF_EMPTY_H
+#define LINQ_PLUSPLUS_DEFAULT_IF_EMPTY_H
+
+#include "Enumerator.h"
+#include <memory>
+
+namespace LinqPlusPlus
+{
+    namespace Enumerators
+    {
+        // Passes the source through, or produces the default value alone if the source turns out to be empty. Which
+        // one is only found out by the first move_next or push, and the element it reads is the first produced, so
+        // sources that can't be rewound, such as queues, lose nothing.
+        template <typename T>
+        class DefaultIfEmpty: public Enumerator<T>
+        {
+        public:
+            DefaultIfEmpty(std::shared_ptr<Enumerator<T> > source, const T& defaultValue)
+                : source_(source)
+                , defaultValue_(defaultValue)
+                , state_(Reset)
+            {
+            }
+
+            DefaultIfEmpty(const DefaultIfEmpty& other)
+                : source_(other.source_)
+                , defaultValue_(other.defaultValue_)
+                , state_(other.state_)
+            {
+            }
+
+            virtual ~DefaultIfEmpty(){}
+
+            DefaultIfEmpty& operator=(const DefaultIfEmpty& rhs)
+            {
+                source_ = rhs.source_;
+                defaultValue_ = rhs.defaultValue_;
+                state_ = rhs.state_;
+
+                return *this;
+            }
+
+            virtual T& current_ref() override
+            {
+                return state_ == Default ? defaultValue_ : source_->current_ref();
+            }
+
+            virtual T current() const override
+            {
+                return state_ == Default ? defaultValue_ : source_->current();
+            }
+
+            virtual bool move_next() override
+            {
+                switch (state_)
+                {
+                case Reset:
+                    state_ = source_->move_next() ? Source : Default;
+                    return true;
+
+                case Source:
+                    return source_->move_next();
+
+                case Default:
+                    state_ = Done;
+                    return false;
+
+                default:
+                    return false;
+                }
+            }
+
+            virtual bool movable() const override
+            {
+                return source_->movable();
+            }
+
+            virtual void reset() override
+            {
+                source_->reset();
+                state_ = Reset;
+            }
+
+            virtual bool push(const std::function<bool(T&)>& sink) override
+            {
+                if (state_ != Reset)
+                {
+                    return Enumerator<T>::push(sink);
+                }
+
+                state_ = Source;
+                bool empty = true;
+                bool finished = source_->push([&](T& t){ empty = false; return sink(t); });
+
+                if (!empty)
+                {
+                    return finished;
+                }
+
+                state_ = Done;
+                return sink(defaultValue_);
+            }
+
+        private:
+            enum State { Reset, Source, Default, Done };
+
+            std::shared_ptr<Enumerator<T> > source_;
+            T defaultValue_;
+            State state_;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef LINQ_PLUSPLUS_DEFERRED_H
+#define LINQ_PLUSPLUS_DEFERRED_H
+
+#include "Enumerator.h"
+#include "RandomAccess.h"
+#include <assert.h>
+#include <functional>
+#include <memory>
+
+namespace LinqPlusPlus
+{
+    namespace Enumerators
+    {
+        // For operators such as the in-memory order_by that have to read their whole source before they can produce
+        // anything. The random access enumerator over the results is built on the first move_next, push or seek
+        // rather than when this one is created, so building a query or asking it for random access doesn't run the
+        // source. reset rewinds the results rather than building them again; copies build their own. movable says
+        // whether the results belong to the enumeration, as for Enumerator::movable.
+        template <typename T>
+        class Deferred: public Enumerator<T>, public RandomAccess
+        {
+        public:
+            typedef std::function<std::shared_ptr<Enumerator<T> >()> Build;
+
+            explicit Deferred(Build build, bool movable = true)
+                : build_(build)
+                , movable_(movable)
+                , random_(nullptr)
+            {
+            }
+
+            Deferred(const Deferred& other)
+                : build_(other.build_)
+                , movable_(other.movable_)
+                , random_(nullptr)
+            {
+            }
+
+            virtual ~Deferred(){}
+
+            Deferred& operator=(const Deferred& rhs)
+            {
+                build_ = rhs.build_;
+                movable_ = rhs.movable_;
+                built_.reset();
+                random_ = nullptr;
+
+                return *this;
+            }
+
+            virtual T& current_ref() override
+            {
+                assert(built_);
+                return built_->current_ref();
+            }
+
+            virtual T current() const override
+            {
+                assert(built_);
+                return built_->current();
+            }
+
+            virtual bool move_next() override
+            {
+                return built().move_next();
+            }
+
+            virtual void reset() override
+            {
+                if (built_)
+                {
+                    built_->reset();
+                }
+            }
+
+            virtual bool movable() const override
+            {
+                return movable_;
+            }
+
+            virtual bool push(const std::function<bool(T&)>& sink) override
+            {
+                return built().push(sink);
+            }
+
+            virtual bool push_blocks(const std::function<bool(T*, size_t)>& sink) override
+            {
+                return built().push_blocks(sink);
+            }
+
+            virtual RandomAccess* random_access() override
+            {
+                return this;
+            }
+
+            virtual size_t size() const override
+            {
+                built();
+                return random_->size();
+            }
+
+            virtual bool seek(size_t index) override
+            {
+                built();
+                return random_->seek(index);
+            }
+
+        private:
+            Enumerator<T>& built() const
+            {
+                if (!built_)
+                {
+                    built_ = build_();
+                    random_ = built_->random_access();
+                    assert(random_ != nullptr);
+                }
+
+                return *built_;
+            }
+
+            Build build_;
+            bool movable_;
+            mutable std::shared_ptr<Enumerator<T> > built_;
+            mutable RandomAccess* random_;
+        };
+    }
+}
+
+#endif
@@ -1,8 +1,17 @@
 #ifndef LINQ_PLUSPLUS_ENUMERATOR_H
 #define LINQ_PLUSPLUS_ENUMERATOR_H
 
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+
 namespace LinqPlusPlus
 {
+    namespace Enumerators
+    {
+        class RandomAccess;
+    }
+
     template <typename T>
     class Enumerator
     {
@@ -20,7 +29,76 @@ namespace LinqPlusPlus
         virtual bool move_next() = 0;
 
         virtual void reset() = 0;
+
+        // Whether the elements current_ref() refers to belong to this enumeration, so that a query marked with consume()
+        // may move them out instead of copying them. Elements of a container the caller lent or shares are not.
+        virtual bool movable() const
+        {
+            return false;
+        }
+
+        // Whether push and move_next may be called again once the elements have run out, without a reset, to carry on
+        // with any appended to the source since. Sources that grow in place are, and so are operators that work one
+        // element at a time over them; incremental_aggregate only accepts queries that are.
+        virtual bool resumable() const
+        {
+            return false;
+        }
+
+        // Non-null if the elements can be reached directly, without enumerating the ones before them.
+        virtual Enumerators::RandomAccess* random_access()
+        {
+            return nullptr;
+        }
+
+        // Push execution: hands each remaining element, the ones move_next would reach from here, to sink until
+        // the sink returns false or the elements run out, and returns false if the sink stopped it. Operators
+        // override it to loop over their source and call the sink directly rather than answering move_next and
+        // current_ref for every element. The enumerator has to be reset before it is used again, unless it is resumable.
+        virtual bool push(const std::function<bool(T&)>& sink)
+        {
+            while (move_next())
+            {
+                if (!sink(current_ref()))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        // Push execution in blocks: like push, but hands the elements over as runs that lie next to each other in
+        // memory, so a terminal can fold them in tight loops the compiler vectorizes. Sources over arrays and
+        // vectors hand over everything left in one run; by default each element is a run of its own.
+        virtual bool push_blocks(const std::function<bool(T*, size_t)>& sink)
+        {
+            return push([&](T& t){ return sink(&t, 1); });
+        }
     };
+
+    namespace Enumerators
+    {
+        template <typename T>
+        T copy_value(const T& value, std::true_type)
+        {
+            return value;
+        }
+
+        template <typename T>
+        T copy_value(const T&, std::false_type)
+        {
+            throw std::runtime_error("Invalid operation: elements of a move-only type can't be copied, use current_ref or consume");
+        }
+
+        // Lets enumerators implement current() for element types that can only be moved; such elements must
+        // be read through current_ref() instead.
+        template <typename T>
+        T copy_value(const T& value)
+        {
+            return copy_value(value, std::is_copy_constructible<T>());
+        }
+    }
 }
 
 #endif
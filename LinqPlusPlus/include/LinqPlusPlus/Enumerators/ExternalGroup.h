@@ -0,0 +1,273 @@
+#ifndef LINQ_PLUSPLUS_EXTERNAL_GROUP_H
+#define LINQ_PLUSPLUS_EXTERNAL_GROUP_H
+
+#include "Enumerator.h"
+#include "../Optional.h"
+#include "../Spill/Serializer.h"
+#include "../Spill/SpillFile.h"
+#include <functional>
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+namespace LinqPlusPlus
+{
+    namespace Enumerators
+    {
+        // Groups elements by key within a memory budget, in bytes as estimated by Spill::Serializer. The first
+        // move_next reads the whole source into groups. If they go over the budget, the groups built so far and every
+        // element after them are hash partitioned by key into temporary files, and the groups are then rebuilt one
+        // partition at a time, so only a single partition is held in memory while the results stream out. A
+        // partition that goes over the budget itself is partitioned again on other bits of the hash, before the
+        // partitions after it, until the keys can be told apart no further; a single group larger than the budget
+        // is still held in memory whole.
+        //
+        // Groups come out in key order, or once spilled in key order within each partition. Elements keep their
+        // source order within a group.
+        template <typename T, typename TKey>
+        class ExternalGroup: public Enumerator<std::pair<TKey, std::vector<T> > >
+        {
+        public:
+            typedef std::pair<TKey, std::vector<T> > Group;
+
+            ExternalGroup(std::shared_ptr<Enumerator<T> > source, std::function<TKey(const T&)> keySelector,
+                          size_t memoryBudget, bool consuming)
+                : source_(source)
+                , keySelector_(keySelector)
+                , memoryBudget_(memoryBudget)
+                , consuming_(consuming)
+                , built_(false)
+                , nextPartition_(0)
+            {
+            }
+
+            // Copies start again from the beginning, since spilled partitions can't be shared.
+            ExternalGroup(const ExternalGroup& other)
+                : source_(other.source_)
+                , keySelector_(other.keySelector_)
+                , memoryBudget_(other.memoryBudget_)
+                , consuming_(other.consuming_)
+                , built_(false)
+                , nextPartition_(0)
+            {
+            }
+
+            virtual ~ExternalGroup(){}
+
+            ExternalGroup& operator=(const ExternalGroup& rhs)
+            {
+                source_ = rhs.source_;
+                keySelector_ = rhs.keySelector_;
+                memoryBudget_ = rhs.memoryBudget_;
+                consuming_ = rhs.consuming_;
+                clear();
+
+                return *this;
+            }
+
+            virtual Group& current_ref() override
+            {
+                return *current_;
+            }
+
+            virtual Group current() const override
+            {
+                return copy_value(*current_);
+            }
+
+            virtual bool move_next() override
+            {
+                if (!built_)
+                {
+                    build();
+                    built_ = true;
+                }
+
+                while (position_ == groups_.end())
+                {
+                    if (nextPartition_ == partitions_.size())
+                    {
+                        current_.reset();
+                        return false;
+                    }
+
+                    load(nextPartition_++);
+                }
+
+                current_ = Optional<Group>(Group(position_->first, std::move(position_->second)));
+                ++position_;
+
+                return true;
+            }
+
+            virtual bool movable() const override
+            {
+                return true;
+            }
+
+            virtual void reset() override
+            {
+                source_->reset();
+                clear();
+            }
+
+        private:
+            static const size_t PartitionBits = 5;
+            static const size_t PartitionCount = 1 << PartitionBits;
+            static const size_t MaxLevels = 64 / PartitionBits;
+
+            // A spill file, and how many times its keys have been partitioned.
+            typedef std::pair<std::shared_ptr<Spill::SpillFile>, size_t> Partition;
+
+            // Roughly what a std::map node costs on top of its key and value.
+            static const size_t NodeOverhead = 48;
+
+            void clear()
+            {
+                built_ = false;
+                groups_.clear();
+                position_ = groups_.end();
+                partitions_.clear();
+                nextPartition_ = 0;
+                current_.reset();
+            }
+
+            void build()
+            {
+                clear();
+                size_t buffered = 0;
+
+                source_->push([&](T& element)
+                {
+                    TKey key = keySelector_(element);
+
+                    if (!partitions_.empty())
+                    {
+                        Spill::Serializer<T>::write(partition_of(key, 0, 0), element);
+                        return true;
+                    }
+
+                    buffered += add(std::move(key), consuming_ ? std::move(element) : copy_value(element));
+
+                    if (buffered > memoryBudget_)
+                    {
+                        spill(0, 0);
+                    }
+
+                    return true;
+                });
+
+                rewind(0, partitions_.size());
+                position_ = groups_.begin();
+            }
+
+            // Adds the element to the groups, and returns roughly how much more memory they take up.
+            size_t add(TKey&& key, T&& element)
+            {
+                size_t added = Spill::Serializer<T>::footprint(element);
+                typename std::map<TKey, std::vector<T> >::iterator group = groups_.find(key);
+
+                if (group == groups_.end())
+                {
+                    added += Spill::Serializer<TKey>::footprint(key) + sizeof(std::vector<T>) + NodeOverhead;
+                    group = groups_.insert(std::make_pair(std::move(key), std::vector<T>())).first;
+                }
+
+                group->second.push_back(std::move(element));
+                return added;
+            }
+
+            // Opens PartitionCount partitions of the given level at index first, and moves the groups into them.
+            void spill(size_t first, size_t level)
+            {
+                for (size_t i = 0; i < PartitionCount; ++i)
+                {
+                    partitions_.insert(partitions_.begin() + first + i, Partition(std::make_shared<Spill::SpillFile>(), level));
+                }
+
+                for (const std::pair<const TKey, std::vector<T> >& group : groups_)
+                {
+                    Spill::SpillFile& partition = partition_of(group.first, first, level);
+
+                    for (const T& element : group.second)
+                    {
+                        Spill::Serializer<T>::write(partition, element);
+                    }
+                }
+
+                groups_.clear();
+            }
+
+            void rewind(size_t first, size_t count)
+            {
+                for (size_t i = first; i < first + count; ++i)
+                {
+                    partitions_[i].first->rewind();
+                }
+            }
+
+            // Each level of partitioning takes the next PartitionBits bits of the key's hash.
+            Spill::SpillFile& partition_of(const TKey& key, size_t first, size_t level)
+            {
+                uint64_t hash = Spill::SerializedHash::of(key) >> (level * PartitionBits);
+                return *partitions_[first + hash % PartitionCount].first;
+            }
+
+            void load(size_t partition)
+            {
+                groups_.clear();
+
+                // Done with this partition once it's read, so give the disk space back then rather than at the end.
+                std::shared_ptr<Spill::SpillFile> file = std::move(partitions_[partition].first);
+                size_t level = partitions_[partition].second;
+                bool split = false;
+                size_t buffered = 0;
+
+                T element;
+                while (Spill::Serializer<T>::read(*file, element))
+                {
+                    TKey key = keySelector_(element);
+
+                    if (split)
+                    {
+                        Spill::Serializer<T>::write(partition_of(key, partition + 1, level + 1), element);
+                        continue;
+                    }
+
+                    buffered += add(std::move(key), std::move(element));
+
+                    if (buffered > memoryBudget_ && groups_.size() > 1 && level + 1 < MaxLevels)
+                    {
+                        spill(partition + 1, level + 1);
+                        split = true;
+                    }
+                }
+
+                if (split)
+                {
+                    rewind(partition + 1, PartitionCount);
+                }
+
+                position_ = groups_.begin();
+            }
+
+            std::shared_ptr<Enumerator<T> > source_;
+            std::function<TKey(const T&)> keySelector_;
+            size_t memoryBudget_;
+            bool consuming_;
+            bool built_;
+
+            // The groups being enumerated: all of them, or once spilled those of the partition last loaded.
+            std::map<TKey, std::vector<T> > groups_;
+            typename std::map<TKey, std::vector<T> >::iterator position_;
+
+            std::vector<Partition> partitions_;
+            size_t nextPartition_;
+            Optional<Group> current_;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,253 @@
+#ifndef LINQ_PLUSPLUS_EXTERNAL_SORT_H
+#define LINQ_PLUSPLUS_EXTERNAL_SORT_H
+
+#include "Enumerator.h"
+#include "../Optional.h"
+#include "../Spill/Serializer.h"
+#include "../Spill/SpillFile.h"
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace LinqPlusPlus
+{
+    namespace Enumerators
+    {
+        // Stable sort by key within a memory budget, in bytes as estimated by Spill::Serializer. The first move_next
+        // reads the whole source; whenever the buffered elements go over the budget they're sorted and written out to
+        // a temporary file as a run. If anything was spilled the runs are then merged, reading one element at a time
+        // from each, so only one element per run is held in memory while the results stream out.
+        template <typename T, typename TKey>
+        class ExternalSort: public Enumerator<T>
+        {
+        public:
+            ExternalSort(std::shared_ptr<Enumerator<T> > source, std::function<TKey(const T&)> keySelector,
+                         size_t memoryBudget, bool consuming)
+                : source_(source)
+                , keySelector_(keySelector)
+                , memoryBudget_(memoryBudget)
+                , consuming_(consuming)
+                , sorted_(false)
+                , next_(0)
+                , lastRun_(NoRun)
+            {
+            }
+
+            // Copies start again from the beginning, since spilled runs can't be shared.
+            ExternalSort(const ExternalSort& other)
+                : source_(other.source_)
+                , keySelector_(other.keySelector_)
+                , memoryBudget_(other.memoryBudget_)
+                , consuming_(other.consuming_)
+                , sorted_(false)
+                , next_(0)
+                , lastRun_(NoRun)
+            {
+            }
+
+            virtual ~ExternalSort(){}
+
+            ExternalSort& operator=(const ExternalSort& rhs)
+            {
+                source_ = rhs.source_;
+                keySelector_ = rhs.keySelector_;
+                memoryBudget_ = rhs.memoryBudget_;
+                consuming_ = rhs.consuming_;
+                clear();
+
+                return *this;
+            }
+
+            virtual T& current_ref() override
+            {
+                return runs_.empty() ? buffer_[next_ - 1].second : *current_;
+            }
+
+            virtual T current() const override
+            {
+                return copy_value(runs_.empty() ? buffer_[next_ - 1].second : *current_);
+            }
+
+            virtual bool move_next() override
+            {
+                if (!sorted_)
+                {
+                    sort();
+                    sorted_ = true;
+                }
+
+                if (runs_.empty())
+                {
+                    if (next_ >= buffer_.size())
+                    {
+                        return false;
+                    }
+
+                    ++next_;
+                    return true;
+                }
+
+                return merge_next();
+            }
+
+            virtual bool movable() const override
+            {
+                return true;
+            }
+
+            virtual void reset() override
+            {
+                source_->reset();
+                clear();
+            }
+
+        private:
+            static const size_t NoRun = static_cast<size_t>(-1);
+
+            struct Head
+            {
+                Head(TKey&& key, T&& value, size_t run)
+                    : key(std::move(key))
+                    , value(std::move(value))
+                    , run(run)
+                {
+                }
+
+                TKey key;
+                T value;
+                size_t run;
+            };
+
+            // Ordering for the merge heap, which puts the greatest element first, so the earliest key ends up on top
+            // and ties go to the earlier run to keep the sort stable.
+            static bool later(const Head& x, const Head& y)
+            {
+                return y.key < x.key || (!(x.key < y.key) && y.run < x.run);
+            }
+
+            static bool key_less(const std::pair<TKey, T>& x, const std::pair<TKey, T>& y)
+            {
+                return x.first < y.first;
+            }
+
+            void clear()
+            {
+                sorted_ = false;
+                buffer_.clear();
+                next_ = 0;
+                runs_.clear();
+                heap_.clear();
+                lastRun_ = NoRun;
+                current_.reset();
+            }
+
+            void sort()
+            {
+                clear();
+                size_t buffered = 0;
+
+                source_->push([&](T& element)
+                {
+                    TKey key = keySelector_(element);
+                    buffered += Spill::Serializer<T>::footprint(element) + Spill::Serializer<TKey>::footprint(key);
+                    buffer_.push_back(std::pair<TKey, T>(std::move(key), consuming_ ? std::move(element) : copy_value(element)));
+
+                    if (buffered > memoryBudget_)
+                    {
+                        spill();
+                        buffered = 0;
+                    }
+
+                    return true;
+                });
+
+                if (runs_.empty())
+                {
+                    std::stable_sort(buffer_.begin(), buffer_.end(), key_less);
+                    return;
+                }
+
+                if (!buffer_.empty())
+                {
+                    spill();
+                }
+
+                std::vector<std::pair<TKey, T> >().swap(buffer_);
+
+                for (size_t run = 0; run < runs_.size(); ++run)
+                {
+                    runs_[run]->rewind();
+                    read_head(run);
+                }
+            }
+
+            void spill()
+            {
+                std::stable_sort(buffer_.begin(), buffer_.end(), key_less);
+
+                std::shared_ptr<Spill::SpillFile> run = std::make_shared<Spill::SpillFile>();
+                for (const std::pair<TKey, T>& element : buffer_)
+                {
+                    Spill::Serializer<T>::write(*run, element.second);
+                }
+
+                runs_.push_back(run);
+                buffer_.clear();
+            }
+
+            void read_head(size_t run)
+            {
+                T value;
+
+                if (Spill::Serializer<T>::read(*runs_[run], value))
+                {
+                    heap_.push_back(Head(keySelector_(value), std::move(value), run));
+                    std::push_heap(heap_.begin(), heap_.end(), later);
+                }
+            }
+
+            bool merge_next()
+            {
+                if (lastRun_ != NoRun)
+                {
+                    read_head(lastRun_);
+                    lastRun_ = NoRun;
+                }
+
+                if (heap_.empty())
+                {
+                    current_.reset();
+                    return false;
+                }
+
+                std::pop_heap(heap_.begin(), heap_.end(), later);
+                current_ = Optional<T>(std::move(heap_.back().value));
+                lastRun_ = heap_.back().run;
+                heap_.pop_back();
+
+                return true;
+            }
+
+            std::shared_ptr<Enumerator<T> > source_;
+            std::function<TKey(const T&)> keySelector_;
+            size_t memoryBudget_;
+            bool consuming_;
+            bool sorted_;
+
+            // Used when nothing was spilled: the sorted elements, and the position after the current one.
+            std::vector<std::pair<TKey, T> > buffer_;
+            size_t next_;
+
+            // Used once something was spilled: the runs, the next element of each, and the run that the current
+            // element came from, which is read from next.
+            std::vector<std::shared_ptr<Spill::SpillFile> > runs_;
+            std::vector<Head> heap_;
+            size_t lastRun_;
+            Optional<T> current_;
+        };
+    }
+}
+
+#endif
@@ -2,44 +2,99 @@
 #define LINQ_PLUSPLUS_FILTER_ENUMERATOR_H
 
 #include "Enumerator.h"
+#include <algorithm>
+#include <chrono>
 #include <functional>
+#include <limits>
+#include <memory>
+#include <stdint.h>
+#include <vector>
 
 namespace LinqPlusPlus
 {
     namespace Enumerators
     {
+        struct PredicateStatistics
+        {
+            explicit PredicateStatistics(size_t position)
+                : position(position)
+                , evaluated(0)
+                , passed(0)
+                , nanoseconds(0)
+            {
+            }
+
+            double pass_rate() const
+            {
+                return evaluated == 0 ? 1.0 : static_cast<double>(passed) / evaluated;
+            }
+
+            double cost() const
+            {
+                return evaluated == 0 ? 0.0 : static_cast<double>(nanoseconds) / evaluated;
+            }
+
+            // Expected cost of evaluating this predicate per element it rejects; cheap, selective predicates rank lowest.
+            double rank() const
+            {
+                double rejectRate = 1.0 - pass_rate();
+                return rejectRate > 0.0 ? cost() / rejectRate : std::numeric_limits<double>::max();
+            }
+
+            size_t position;
+            size_t evaluated;
+            size_t passed;
+            uint64_t nanoseconds;
+        };
+
         template <typename T>
         class Filter : public Enumerator<T>
         {
         public:
-            Filter(Enumerator<T>& source, std::function<bool(const T&)> filter)
+            typedef std::function<bool(const T&)> Predicate;
+            typedef std::function<void(const std::vector<PredicateStatistics>&)> Observer;
+
+            Filter(std::shared_ptr<Enumerator<T> > source, Predicate filter)
                 : source_(source)
-                , filter_(filter)
+                , predicates_(1, filter)
+                , statistics_(1, PredicateStatistics(0))
+                , sampleSize_(0)
+                , resampleInterval_(0)
+                , seen_(0)
+                , observer_(nullptr)
             {
             }
 
             Filter(const Filter& other)
                 : source_(other.source_)
-                , filter_(other.filter_)
-
+                , predicates_(other.predicates_)
+                , statistics_(other.statistics_)
+                , sampleSize_(other.sampleSize_)
+                , resampleInterval_(other.resampleInterval_)
+                , seen_(other.seen_)
+                , observer_(other.observer_)
             {
             }
 
             virtual ~Filter()
             {
-                filter_ = nullptr;
             }
 
             Filter& operator=(const Filter& rhs)
             {
                 source_ = rhs.source_;
-                filter_ = rhs.filter_;
+                predicates_ = rhs.predicates_;
+                statistics_ = rhs.statistics_;
+                sampleSize_ = rhs.sampleSize_;
+                resampleInterval_ = rhs.resampleInterval_;
+                seen_ = rhs.seen_;
+                observer_ = rhs.observer_;
                 return *this;
             }
 
             bool operator==(const Filter& rhs) const
             {
-                return this == &rhs || (source_ == rhs.source_ && filter_ == rhs.filter_);
+                return this == &rhs || (source_ == rhs.source_ && predicates_.size() == rhs.predicates_.size());
             }
 
             bool operator!=(const Filter& rhs) const
@@ -47,27 +102,74 @@ namespace LinqPlusPlus
                 return !(*this == rhs);
             }
 
-            Filter& where(std::function<bool(const T&)> filter)
+            // Fuses another predicate into this filter; predicates are evaluated in the order added unless adaptive.
+            Filter& where(Predicate filter)
+            {
+                predicates_.push_back(filter);
+                statistics_.push_back(PredicateStatistics(predicates_.size() - 1));
+                seen_ = 0;
+                return *this;
+            }
+
+            // Opts in to reordering the fused predicates by observed cost and selectivity. Every predicate is evaluated
+            // (and timed) for the first sampleSize elements of each window, after which the cheapest, most selective
+            // predicates are moved to the front; a new window starts every resampleInterval elements after that.
+            // Predicates must be free of side effects and must not rely on being guarded by earlier predicates.
+            // observer, if given, is called with the statistics after each reordering.
+            Filter& adaptive(size_t sampleSize, size_t resampleInterval, Observer observer = nullptr)
             {
-                filter_ = [=](const T& t){ return filter_(t) && filter(t); };
+                sampleSize_ = sampleSize;
+                resampleInterval_ = resampleInterval;
+                observer_ = observer;
+                seen_ = 0;
                 return *this;
             }
 
+            // Statistics for the current sampling window, in evaluation order; position is the order the predicate
+            // was originally added in.
+            const std::vector<PredicateStatistics>& statistics() const
+            {
+                return statistics_;
+            }
+
+            const std::shared_ptr<Enumerator<T> >& source() const
+            {
+                return source_;
+            }
+
+            bool accepts(const T& t)
+            {
+                if (sampleSize_ > 0 && advance_window())
+                {
+                    return sample(t);
+                }
+
+                for (auto it = predicates_.begin(); it != predicates_.end(); ++it)
+                {
+                    if (!(*it)(t))
+                    {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
             virtual T& current_ref() override
             {
-                return source_.current_ref();
+                return source_->current_ref();
             }
 
             virtual T current() const override
             {
-                return source_.current();
+                return source_->current();
             }
 
             virtual bool move_next() override
             {
-                while (source_.move_next())
+                while (source_->move_next())
                 {
-                    if (filter_(source_.current_ref()))
+                    if (accepts(source_->current_ref()))
                     {
                         return true;
                     }
@@ -76,14 +178,133 @@ namespace LinqPlusPlus
                 return false;
             }
 
+            virtual bool movable() const override
+            {
+                return source_->movable();
+            }
+
+            virtual bool resumable() const override
+            {
+                return source_->resumable();
+            }
+
+            // Also puts the predicates back in the order they were added, so the next pass samples afresh.
             virtual void reset() override
             {
-                source_.reset();
+                source_->reset();
+
+                std::vector<Predicate> predicates(predicates_.size());
+                std::vector<PredicateStatistics> statistics;
+                for (size_t i = 0; i < predicates_.size(); ++i)
+                {
+                    predicates[statistics_[i].position] = predicates_[i];
+                    statistics.push_back(PredicateStatistics(i));
+                }
+
+                predicates_.swap(predicates);
+                statistics_.swap(statistics);
+                seen_ = 0;
+            }
+
+            virtual bool push(const std::function<bool(T&)>& sink) override
+            {
+                return source_->push([&](T& t){ return !accepts(t) || sink(t); });
             }
 
         private:
-            Enumerator<T>& source_;
-            std::function<bool(const T&)> filter_;
+            // Returns true while the current element falls inside a sampling window.
+            bool advance_window()
+            {
+                if (seen_ == 0)
+                {
+                    for (auto it = statistics_.begin(); it != statistics_.end(); ++it)
+                    {
+                        *it = PredicateStatistics(it->position);
+                    }
+                }
+
+                if (seen_ < sampleSize_)
+                {
+                    ++seen_;
+                    return true;
+                }
+
+                if (seen_ == sampleSize_)
+                {
+                    reorder();
+                }
+
+                if (resampleInterval_ == 0)
+                {
+                    seen_ = sampleSize_ + 1;
+                }
+                else
+                {
+                    seen_ = (seen_ - sampleSize_ + 1 < resampleInterval_) ? seen_ + 1 : 0;
+                }
+
+                return false;
+            }
+
+            bool sample(const T& t)
+            {
+                bool accepted = true;
+
+                for (size_t i = 0; i < predicates_.size(); ++i)
+                {
+                    auto start = std::chrono::steady_clock::now();
+                    bool passed = predicates_[i](t);
+                    auto elapsed = std::chrono::steady_clock::now() - start;
+
+                    PredicateStatistics& statistics = statistics_[i];
+                    ++statistics.evaluated;
+                    statistics.passed += passed ? 1 : 0;
+                    statistics.nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+
+                    accepted = accepted && passed;
+                }
+
+                return accepted;
+            }
+
+            void reorder()
+            {
+                std::vector<size_t> order(predicates_.size());
+                for (size_t i = 0; i < order.size(); ++i)
+                {
+                    order[i] = i;
+                }
+
+                const std::vector<PredicateStatistics>& statistics = statistics_;
+                std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs)
+                {
+                    return statistics[lhs].rank() < statistics[rhs].rank();
+                });
+
+                std::vector<Predicate> predicates;
+                std::vector<PredicateStatistics> reordered;
+                for (auto it = order.begin(); it != order.end(); ++it)
+                {
+                    predicates.push_back(predicates_[*it]);
+                    reordered.push_back(statistics_[*it]);
+                }
+
+                predicates_.swap(predicates);
+                statistics_.swap(reordered);
+
+                if (observer_ != nullptr)
+                {
+                    observer_(statistics_);
+                }
+            }
+
+            std::shared_ptr<Enumerator<T> > source_;
+            std::vector<Predicate> predicates_;
+            std::vector<PredicateStatistics> statistics_;
+            size_t sampleSize_;
+            size_t resampleInterval_;
+            size_t seen_;
+            Observer observer_;
         };
     }
 }
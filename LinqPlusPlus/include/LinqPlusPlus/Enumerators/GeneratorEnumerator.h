@@ -0,0 +1,87 @@
+#ifndef LINQ_PLUSPLUS_GENERATOR_ENUMERATOR_H
+#define LINQ_PLUSPLUS_GENERATOR_ENUMERATOR_H
+
+#include "Enumerator.h"
+#include "../Coroutines/AsyncGenerator.h"
+#include "../Coroutines/Generator.h"
+#include "../Optional.h"
+#include <functional>
+
+namespace LinqPlusPlus
+{
+    namespace Enumerators
+    {
+        // Enumerates the elements yielded by a generator coroutine, starting a new coroutine on the first move_next
+        // after construction or reset. Asynchronous generators are waited for.
+        template <typename T, typename Generator>
+        class GeneratorEnumerator: public Enumerator<T>
+        {
+        public:
+            explicit GeneratorEnumerator(std::function<Generator()> coroutine)
+                : coroutine_(coroutine)
+                , generator_()
+            {
+            }
+
+            GeneratorEnumerator(const GeneratorEnumerator& other)
+                : coroutine_(other.coroutine_)
+                , generator_()
+            {
+            }
+
+            virtual ~GeneratorEnumerator()
+            {
+                // The coroutine may refer to the captures of coroutine_, so it has to go first.
+                generator_.reset();
+            }
+
+            GeneratorEnumerator& operator=(const GeneratorEnumerator& rhs)
+            {
+                generator_.reset();
+                coroutine_ = rhs.coroutine_;
+                return *this;
+            }
+
+            virtual T& current_ref() override
+            {
+                return generator_->current_ref();
+            }
+
+            virtual T current() const override
+            {
+                return copy_value(const_cast<Generator&>(*generator_).current_ref());
+            }
+
+            virtual bool move_next() override
+            {
+                if (!generator_.has_value())
+                {
+                    generator_ = Optional<Generator>(coroutine_());
+                }
+
+                return advance(*generator_);
+            }
+
+            virtual void reset() override
+            {
+                generator_.reset();
+            }
+
+        private:
+            static bool advance(Coroutines::Generator<T>& generator)
+            {
+                return generator.move_next();
+            }
+
+            static bool advance(Coroutines::AsyncGenerator<T>& generator)
+            {
+                return generator.wait_next();
+            }
+
+            std::function<Generator()> coroutine_;
+            Optional<Generator> generator_;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,168 @@
+#ifndef LINQ_PLUSPLUS_INSTRUMENTED_ENUMERATOR_H
+#define LINQ_PLUSPLUS_INSTRUMENTED_ENUMERATOR_H
+
+#include "Enumerator.h"
+#include "../Diagnostics/OperatorStatistics.h"
+#include "../Diagnostics/Trace.h"
+#include <memory>
+
+namespace LinqPlusPlus
+{
+    namespace Enumerators
+    {
+        // Counts every call into the wrapped operator. While a Diagnostics::Trace is running, each pass over the
+        // operator (from the first move_next until it is exhausted or reset) is also recorded as an "operator" span.
+        template <typename T>
+        class Instrumented : public Enumerator<T>
+        {
+        public:
+            Instrumented(std::shared_ptr<Enumerator<T> > inner, Diagnostics::OperatorStatistics::Ptr statistics)
+                : inner_(inner)
+                , statistics_(statistics)
+                , traceName_(Diagnostics::Trace::NoName)
+                , traceStart_(0)
+            {
+            }
+
+            Instrumented(const Instrumented& other)
+                : inner_(other.inner_)
+                , statistics_(other.statistics_)
+                , traceName_(other.traceName_)
+                , traceStart_(0)
+            {
+            }
+
+            virtual ~Instrumented()
+            {
+                end_trace();
+            }
+
+            Instrumented& operator=(const Instrumented& rhs)
+            {
+                inner_ = rhs.inner_;
+                statistics_ = rhs.statistics_;
+                traceName_ = rhs.traceName_;
+                traceStart_ = 0;
+                return *this;
+            }
+
+            const std::shared_ptr<Enumerator<T> >& inner() const
+            {
+                return inner_;
+            }
+
+            const Diagnostics::OperatorStatistics::Ptr& statistics() const
+            {
+                return statistics_;
+            }
+
+            virtual T& current_ref() override
+            {
+                Diagnostics::OperatorStatistics::Measurement measurement(*statistics_);
+                return inner_->current_ref();
+            }
+
+            virtual T current() const override
+            {
+                return inner_->current();
+            }
+
+            virtual bool move_next() override
+            {
+                if (traceStart_ == 0 && Diagnostics::Trace::enabled())
+                {
+                    traceStart_ = Diagnostics::Trace::now();
+                }
+
+                bool moved;
+                {
+                    Diagnostics::OperatorStatistics::Measurement measurement(*statistics_);
+                    moved = inner_->move_next();
+                    statistics_->record_move_next(moved);
+                }
+
+                if (!moved)
+                {
+                    end_trace();
+                }
+
+                return moved;
+            }
+
+            virtual bool movable() const override
+            {
+                return inner_->movable();
+            }
+
+            virtual bool resumable() const override
+            {
+                return inner_->resumable();
+            }
+
+            virtual void reset() override
+            {
+                end_trace();
+                inner_->reset();
+            }
+
+            // Seeking goes straight to the inner enumerator, so it isn't counted.
+            virtual RandomAccess* random_access() override
+            {
+                return inner_->random_access();
+            }
+
+        private:
+            void end_trace()
+            {
+                if (traceStart_ == 0)
+                {
+                    return;
+                }
+
+                if (Diagnostics::Trace::enabled())
+                {
+                    if (traceName_ == Diagnostics::Trace::NoName)
+                    {
+                        traceName_ = Diagnostics::Trace::intern(statistics_->name());
+                    }
+
+                    Diagnostics::Trace::record("operator", traceName_, traceStart_, Diagnostics::Trace::now());
+                }
+
+                traceStart_ = 0;
+            }
+
+            std::shared_ptr<Enumerator<T> > inner_;
+            Diagnostics::OperatorStatistics::Ptr statistics_;
+            uint32_t traceName_;
+            uint64_t traceStart_;
+        };
+
+        // Strips the instrumentation wrapper, if any, so operators can be fused with the node underneath it.
+        template <typename T>
+        Enumerator<T>& unwrap(Enumerator<T>& enumerator)
+        {
+#ifdef LINQ_PLUSPLUS_INSTRUMENTATION
+            if (auto instrumented = dynamic_cast<Instrumented<T>*>(&enumerator))
+            {
+                return *instrumented->inner();
+            }
+#endif
+            return enumerator;
+        }
+
+        template <typename T>
+        std::shared_ptr<Enumerator<T> > unwrap(const std::shared_ptr<Enumerator<T> >& enumerator)
+        {
+#ifdef LINQ_PLUSPLUS_INSTRUMENTATION
+            if (auto instrumented = std::dynamic_pointer_cast<Instrumented<T> >(enumerator))
+            {
+                return instrumented->inner();
+            }
+#endif
+            return enumerator;
+        }
+    }
+}
+
+#endif
@@ -2,6 +2,8 @@
 #define LINQ_PLUSPLUS_MAP_ENUMERATOR_H
 
 #include "Enumerator.h"
+#include "Filter.h"
+#include "Projection.h"
 #include <functional>
 #include <memory>
 
@@ -10,82 +12,101 @@ namespace LinqPlusPlus
     namespace Enumerators
     {
         template <typename T, typename U>
-        class Map : public Enumerator<U>
+        class Map : public Projection<U>
         {
         public:
-            Map(Enumerator<T>& source, std::function<U (const T&)> map)
-                : source_(source)
-                , map_(map)
-                , cached_()
+            Map(std::shared_ptr<Enumerator<T> > source, std::function<U (const T&)> map)
+                : Projection<U>(
+                    [source]() { return source->move_next(); },
+                    [source]() { source->reset(); },
+                    [source, map]() { return map(source->current_ref()); },
+                    size_of(source),
+                    seek_in(source),
+                    [source, map](const std::function<bool(U&)>& sink)
+                    {
+                        return source->push([&](T& t){ U u = map(t); return sink(u); });
+                    },
+                    source->resumable())
             {
             }
 
-            Map(const Map& other)
-                : source_(other.source_)
-                , map_(other.map_)
-                , cached_()
-            {
-            }
+            // Fuses a filter into the projection: it reads the filter's source and tests the filter's predicates
+            // itself, rather than going through the filter's enumerator for every element.
+            Map(std::shared_ptr<Filter<T> > filter, std::function<U (const T&)> map)
+                : Projection<U>(
+                    [filter]()
+                    {
+                        Enumerator<T>& source = *filter->source();
+                        while (source.move_next())
+                        {
+                            if (filter->accepts(source.current_ref()))
+                            {
+                                return true;
+                            }
+                        }
 
-            virtual ~Map()
-            {
-                map_ = nullptr;
-            }
+                        return false;
+                    },
+                    [filter]() { filter->reset(); },
+                    [filter, map]() { return map(filter->source()->current_ref()); },
+                    nullptr,
+                    nullptr,
+                    [filter, map](const std::function<bool(U&)>& sink)
+                    {
+                        return filter->source()->push([&](T& t)
+                        {
+                            if (!filter->accepts(t))
+                            {
+                                return true;
+                            }
 
-            Map& operator=(const Map& rhs)
+                            U u = map(t);
+                            return sink(u);
+                        });
+                    },
+                    filter->resumable())
             {
-                source_ = rhs.source_;
-                map_ = rhs.map_;
-                cached_ = rhs.cached_;
-                return *this;
             }
 
-            bool operator==(const Map& rhs) const
+            Map(const Map& other)
+                : Projection<U>(other)
             {
-                return this == &rhs || (source_ == rhs.source_ && map_ == rhs.map_);
             }
 
-            bool operator!=(const Map& rhs) const
+            virtual ~Map()
             {
-                return !(*this == rhs);
             }
 
-            template <typename V>
-            Map<U, V> select(std::function<V (const U&)> selector)
+            Map& operator=(const Map& rhs)
             {
-                return Map<U, V>(*this, selector);
+                Projection<U>::operator=(rhs);
+                return *this;
             }
 
-            virtual U& current_ref() override
+        private:
+            static std::function<size_t()> size_of(std::shared_ptr<Enumerator<T> > source)
             {
-                if (cached_ == nullptr)
+                RandomAccess* random = source->random_access();
+
+                if (random == nullptr)
                 {
-                    cached_.reset(new U(map_(source_.current_ref())));
+                    return nullptr;
                 }
 
-                return *cached_;
+                return [source, random]() { return random->size(); };
             }
 
-            virtual U current() const override
+            static std::function<bool(size_t)> seek_in(std::shared_ptr<Enumerator<T> > source)
             {
-                return map_(source_.current_ref());
-            }
+                RandomAccess* random = source->random_access();
 
-            virtual bool move_next() override
-            {
-                cached_.reset();
-                return source_.move_next();
-            }
+                if (random == nullptr)
+                {
+                    return nullptr;
+                }
 
-            virtual void reset() override
-            {
-                source_.reset();
+                return [source, random](size_t index) { return random->seek(index); };
             }
-
-        private:
-            Enumerator<T>& source_;
-            std::function<U (const T&)> map_;
-            std::shared_ptr<U> cached_;
         };
     }
 }
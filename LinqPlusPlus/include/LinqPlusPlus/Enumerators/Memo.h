@@ -0,0 +1,159 @@
+#ifndef LINQ_PLUSPLUS_MEMO_H
+#define LINQ_PLUSPLUS_MEMO_H
+
+#include "Consume.h"
+#include "Enumerator.h"
+#include "Instrumented.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stddef.h>
+#include <utility>
+
+namespace LinqPlusPlus
+{
+    namespace Enumerators
+    {
+        // The elements of a query recorded as they're first asked for, shared by every enumerator of a memoized
+        // query. Elements are recorded one at a time under a lock, only as far as the furthest reader has got, and
+        // are never moved once recorded: the buffer grows by adding blocks, each twice the size of the last, so
+        // readers can use recorded elements without locking while another thread records more.
+        template <typename T>
+        class Memo
+        {
+        public:
+            explicit Memo(std::function<std::shared_ptr<Enumerator<T> > ()> source)
+                : source_(source)
+                , consuming_(false)
+                , recorded_(0)
+                , complete_(false)
+            {
+                for (size_t i = 0; i < MaxBlocks; ++i)
+                {
+                    blocks_[i] = nullptr;
+                }
+            }
+
+            ~Memo()
+            {
+                size_t recorded = recorded_.load(std::memory_order_relaxed);
+                for (size_t i = 0, block = 0, blockSize = FirstBlockSize; i < recorded; ++block, blockSize *= 2)
+                {
+                    for (size_t j = 0; j < blockSize && i < recorded; ++j, ++i)
+                    {
+                        blocks_[block][j].~T();
+                    }
+                }
+
+                for (size_t i = 0; i < MaxBlocks && blocks_[i] != nullptr; ++i)
+                {
+                    ::operator delete(blocks_[i]);
+                }
+            }
+
+            Memo(const Memo&) = delete;
+            Memo& operator=(const Memo&) = delete;
+
+            // Finds the element at index, recording up to it first if need be. Returns how many recorded elements run on
+            // contiguously from it, pointing first at it, or zero if the query has fewer elements.
+            size_t elements(size_t index, T*& first)
+            {
+                size_t recorded = recorded_.load(std::memory_order_acquire);
+
+                if (index >= recorded)
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+
+                    while ((recorded = recorded_.load(std::memory_order_relaxed)) <= index)
+                    {
+                        if (complete_.load(std::memory_order_relaxed) || !record_next())
+                        {
+                            return 0;
+                        }
+                    }
+                }
+
+                size_t block = block_of(index);
+                size_t offset = index - block_start(block);
+                first = blocks_[block] + offset;
+
+                return std::min(recorded - index, (FirstBlockSize << block) - offset);
+            }
+
+            // True once the whole query has been recorded, after which size() is its length.
+            bool complete() const
+            {
+                return complete_.load(std::memory_order_acquire);
+            }
+
+            size_t size() const
+            {
+                return recorded_.load(std::memory_order_acquire);
+            }
+
+        private:
+            static const size_t FirstBlockSize = 16;
+            static const size_t MaxBlocks = sizeof(size_t) * 8 - 4;
+
+            static size_t block_of(size_t index)
+            {
+                size_t block = 0;
+                for (size_t n = index / FirstBlockSize + 1; n > 1; n /= 2)
+                {
+                    ++block;
+                }
+
+                return block;
+            }
+
+            static size_t block_start(size_t block)
+            {
+                return FirstBlockSize * ((size_t(1) << block) - 1);
+            }
+
+            bool record_next()
+            {
+                if (!enumerator_)
+                {
+                    enumerator_ = source_();
+                    consuming_ = dynamic_cast<Consume<T>*>(&unwrap(*enumerator_)) != nullptr && enumerator_->movable();
+                }
+
+                if (!enumerator_->move_next())
+                {
+                    enumerator_.reset();
+                    complete_.store(true, std::memory_order_release);
+                    return false;
+                }
+
+                size_t index = recorded_.load(std::memory_order_relaxed);
+                size_t block = block_of(index);
+
+                if (blocks_[block] == nullptr)
+                {
+                    blocks_[block] = static_cast<T*>(::operator new((FirstBlockSize << block) * sizeof(T)));
+                }
+
+                T& element = enumerator_->current_ref();
+                new (blocks_[block] + (index - block_start(block))) T(consuming_ ? std::move(element) : copy_value(element));
+
+                // Publishes the element, and its block, to readers that don't take the lock.
+                recorded_.store(index + 1, std::memory_order_release);
+                return true;
+            }
+
+            std::mutex mutex_;
+            std::function<std::shared_ptr<Enumerator<T> > ()> source_;
+            std::shared_ptr<Enumerator<T> > enumerator_;
+            bool consuming_;
+            T* blocks_[MaxBlocks];
+            std::atomic<size_t> recorded_;
+            std::atomic<bool> complete_;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef LINQ_PLUSPLUS_MEMO_ENUMERATOR_H
+#define LINQ_PLUSPLUS_MEMO_ENUMERATOR_H
+
+#include "Enumerator.h"
+#include "Memo.h"
+#include "RandomAccess.h"
+#include <functional>
+#include <memory>
+
+namespace LinqPlusPlus
+{
+    namespace Enumerators
+    {
+        // Reads a Memo, replaying what's been recorded and recording more as it goes. Random access once the whole
+        // query has been recorded.
+        template <typename T>
+        class MemoEnumerator: public Enumerator<T>, public RandomAccess
+        {
+        public:
+            explicit MemoEnumerator(std::shared_ptr<Memo<T> > memo)
+                : memo_(memo)
+                , next_(0)
+                , current_(nullptr)
+                , following_(0)
+            {
+            }
+
+            MemoEnumerator(const MemoEnumerator& other)
+                : memo_(other.memo_)
+                , next_(other.next_)
+                , current_(other.current_)
+                , following_(other.following_)
+            {
+            }
+
+            virtual ~MemoEnumerator(){}
+
+            MemoEnumerator& operator=(const MemoEnumerator& rhs)
+            {
+                memo_ = rhs.memo_;
+                next_ = rhs.next_;
+                current_ = rhs.current_;
+                following_ = rhs.following_;
+
+                return *this;
+            }
+
+            virtual T& current_ref() override
+            {
+                return *current_;
+            }
+
+            virtual T current() const override
+            {
+                return copy_value(*current_);
+            }
+
+            virtual bool move_next() override
+            {
+                if (following_ > 0)
+                {
+                    ++current_;
+                    --following_;
+                }
+                else
+                {
+                    size_t available = memo_->elements(next_, current_);
+
+                    if (available == 0)
+                    {
+                        return false;
+                    }
+
+                    following_ = available - 1;
+                }
+
+                ++next_;
+                return true;
+            }
+
+            virtual void reset() override
+            {
+                next_ = 0;
+                current_ = nullptr;
+                following_ = 0;
+            }
+
+            virtual bool push(const std::function<bool(T&)>& sink) override
+            {
+                for (size_t available; (available = memo_->elements(next_, current_)) > 0; )
+                {
+                    following_ = 0;
+
+                    for (T* last = current_ + available - 1; ; ++current_)
+                    {
+                        ++next_;
+
+                        if (!sink(*current_))
+                        {
+                            following_ = static_cast<size_t>(last - current_);
+                            return false;
+                        }
+
+                        if (current_ == last)
+                        {
+                            break;
+                        }
+                    }
+                }
+
+                return true;
+            }
+
+            virtual bool push_blocks(const std::function<bool(T*, size_t)>& sink) override
+            {
+                for (size_t available; (available = memo_->elements(next_, current_)) > 0; )
+                {
+                    T* first = current_;
+                    following_ = 0;
+                    next_ += available;
+                    current_ += available - 1;
+
+                    if (!sink(first, available))
+                    {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            virtual RandomAccess* random_access() override
+            {
+                return memo_->complete() ? this : nullptr;
+            }
+
+            virtual size_t size() const override
+            {
+                return memo_->size();
+            }
+
+            virtual bool seek(size_t index) override
+            {
+                next_ = index;
+                following_ = 0;
+                return move_next();
+            }
+
+        private:
+            std::shared_ptr<Memo<T> > memo_;
+            size_t next_;
+            T* current_;
+
+            // How many more recorded elements follow current_ in the same block.
+            size_t following_;
+        };
+    }
+}
+
+#endif
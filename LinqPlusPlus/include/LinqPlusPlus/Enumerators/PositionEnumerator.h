@@ -0,0 +1,119 @@
+#ifndef LINQ_PLUSPLUS_POSITION_ENUMERATOR_H
+#define LINQ_PLUSPLUS_POSITION_ENUMERATOR_H
+
+#include "Enumerator.h"
+#include "RandomAccess.h"
+#include <assert.h>
+#include <memory>
+#include <stddef.h>
+#include <vector>
+
+namespace LinqPlusPlus
+{
+    namespace Enumerators
+    {
+        // Enumerates the elements of a vector at the positions in positions[begin, end), which is how an
+        // IndexedEnumerable hands out the matches of a lookup, and a DictionaryColumn decodes its codes, without
+        // copying the elements.
+        template <typename T, typename TPosition = size_t>
+        class PositionEnumerator: public Enumerator<T>, public RandomAccess
+        {
+        public:
+            PositionEnumerator(std::shared_ptr<std::vector<T> > elements, std::shared_ptr<const std::vector<TPosition> > positions,
+                               size_t begin, size_t end)
+                : elements_(elements)
+                , positions_(positions)
+                , begin_(begin)
+                , end_(end)
+                , current_(end)
+                , isReset_(true)
+            {
+            }
+
+            PositionEnumerator(const PositionEnumerator& other)
+                : elements_(other.elements_)
+                , positions_(other.positions_)
+                , begin_(other.begin_)
+                , end_(other.end_)
+                , current_(other.current_)
+                , isReset_(other.isReset_)
+            {
+            }
+
+            virtual ~PositionEnumerator(){}
+
+            PositionEnumerator& operator=(const PositionEnumerator& rhs)
+            {
+                elements_ = rhs.elements_;
+                positions_ = rhs.positions_;
+                begin_ = rhs.begin_;
+                end_ = rhs.end_;
+                current_ = rhs.current_;
+                isReset_ = rhs.isReset_;
+
+                return *this;
+            }
+
+            virtual T& current_ref() override
+            {
+                assert(!isReset_ && current_ < end_);
+                return (*elements_)[(*positions_)[current_]];
+            }
+
+            virtual T current() const override
+            {
+                assert(!isReset_ && current_ < end_);
+                return copy_value((*elements_)[(*positions_)[current_]]);
+            }
+
+            virtual bool move_next() override
+            {
+                if (isReset_)
+                {
+                    isReset_ = false;
+                    current_ = begin_;
+                }
+                else if (current_ < end_)
+                {
+                    ++current_;
+                }
+
+                return current_ < end_;
+            }
+
+            virtual void reset() override
+            {
+                isReset_ = true;
+                current_ = end_;
+            }
+
+            virtual RandomAccess* random_access() override
+            {
+                return this;
+            }
+
+            virtual size_t size() const override
+            {
+                return end_ - begin_;
+            }
+
+            virtual bool seek(size_t index) override
+            {
+                isReset_ = false;
+                current_ = index < end_ - begin_ ? begin_ + index : end_;
+
+                return current_ < end_;
+            }
+
+        private:
+            std::shared_ptr<std::vector<T> > elements_;
+            std::shared_ptr<const std::vector<TPosition> > positions_;
+            size_t begin_;
+            size_t end_;
+            size_t current_;
+            bool isReset_;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,173 @@
+#ifndef LINQ_PLUSPLUS_PROJECTION_ENUMERATOR_H
+#define LINQ_PLUSPLUS_PROJECTION_ENUMERATOR_H
+
+#include "Enumerator.h"
+#include "RandomAccess.h"
+#include "../Optional.h"
+#include <functional>
+#include <memory>
+
+namespace LinqPlusPlus
+{
+    namespace Enumerators
+    {
+        // A projection over a source whose element type has been erased: the source is only reachable through
+        // the advance/rewind/project closures. This lets a chain of selects be collapsed into a single node
+        // without the caller needing to know the type the chain started from. A projection of a random access
+        // source is itself random access when it is also given the source's size and seek closures, and pushes
+        // its elements when given a closure that pushes the source's elements through the projection. It is resumable
+        // if the source is. current_ref projects each element once, into storage held inline. Each fused select
+        // still wraps project in one more closure, so a chain of n selects costs n indirect calls per element, but
+        // no extra enumerator, virtual call or allocation.
+        template <typename U>
+        class Projection : public Enumerator<U>, public RandomAccess
+        {
+        public:
+            typedef std::function<bool(const std::function<bool(U&)>&)> Push;
+
+            Projection(std::function<bool()> advance, std::function<void()> rewind, std::function<U()> project,
+                std::function<size_t()> size = nullptr, std::function<bool(size_t)> seek = nullptr, Push push = nullptr,
+                bool resumable = false)
+                : advance_(advance)
+                , rewind_(rewind)
+                , project_(project)
+                , size_(size)
+                , seek_(seek)
+                , push_(push)
+                , resumable_(resumable)
+                , cached_()
+            {
+            }
+
+            Projection(const Projection& other)
+                : advance_(other.advance_)
+                , rewind_(other.rewind_)
+                , project_(other.project_)
+                , size_(other.size_)
+                , seek_(other.seek_)
+                , push_(other.push_)
+                , resumable_(other.resumable_)
+                , cached_()
+            {
+            }
+
+            virtual ~Projection()
+            {
+                advance_ = nullptr;
+                rewind_ = nullptr;
+                project_ = nullptr;
+                size_ = nullptr;
+                seek_ = nullptr;
+                push_ = nullptr;
+            }
+
+            Projection& operator=(const Projection& rhs)
+            {
+                advance_ = rhs.advance_;
+                rewind_ = rhs.rewind_;
+                project_ = rhs.project_;
+                size_ = rhs.size_;
+                seek_ = rhs.seek_;
+                push_ = rhs.push_;
+                resumable_ = rhs.resumable_;
+                cached_.reset();
+                return *this;
+            }
+
+            template <typename V>
+            Projection<V> select(std::function<V (const U&)> selector) const
+            {
+                std::function<U()> project = project_;
+                typename Projection<V>::Push push = nullptr;
+
+                if (push_ != nullptr)
+                {
+                    Push source = push_;
+                    push = [=](const std::function<bool(V&)>& sink)
+                    {
+                        return source([&](U& u){ V v = selector(u); return sink(v); });
+                    };
+                }
+
+                return Projection<V>(advance_, rewind_, [=]() { return selector(project()); }, size_, seek_, push, resumable_);
+            }
+
+            virtual U& current_ref() override
+            {
+                if (!cached_)
+                {
+                    cached_ = Optional<U>(project_());
+                }
+
+                return *cached_;
+            }
+
+            virtual U current() const override
+            {
+                return project_();
+            }
+
+            virtual bool move_next() override
+            {
+                cached_.reset();
+                return advance_();
+            }
+
+            virtual bool movable() const override
+            {
+                return true;
+            }
+
+            virtual bool resumable() const override
+            {
+                return resumable_;
+            }
+
+            virtual void reset() override
+            {
+                cached_.reset();
+                rewind_();
+            }
+
+            virtual bool push(const std::function<bool(U&)>& sink) override
+            {
+                cached_.reset();
+
+                if (push_ == nullptr)
+                {
+                    return Enumerator<U>::push(sink);
+                }
+
+                return push_(sink);
+            }
+
+            virtual RandomAccess* random_access() override
+            {
+                return seek_ != nullptr ? this : nullptr;
+            }
+
+            virtual size_t size() const override
+            {
+                return size_();
+            }
+
+            virtual bool seek(size_t index) override
+            {
+                cached_.reset();
+                return seek_(index);
+            }
+
+        private:
+            std::function<bool()> advance_;
+            std::function<void()> rewind_;
+            std::function<U()> project_;
+            std::function<size_t()> size_;
+            std::function<bool(size_t)> seek_;
+            Push push_;
+            bool resumable_;
+            Optional<U> cached_;
+        };
+    }
+}
+
+#endif
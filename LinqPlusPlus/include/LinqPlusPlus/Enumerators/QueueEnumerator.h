@@ -0,0 +1,124 @@
+#ifndef LINQ_PLUSPLUS_QUEUE_ENUMERATOR_H
+#define LINQ_PLUSPLUS_QUEUE_ENUMERATOR_H
+
+#include "Enumerator.h"
+#include "../Concurrency/Backoff.h"
+#include "../Concurrency/BoundedQueue.h"
+#include "../Optional.h"
+#include <chrono>
+#include <memory>
+
+namespace LinqPlusPlus
+{
+    namespace Enumerators
+    {
+        // How move_next waits for the next element of a queue.
+        enum class QueueWait
+        {
+            // Until an element arrives or the queue is closed, backing off to sleeping during long waits.
+            Block,
+            // As Block, but never sleeps: lowest latency, at the cost of a busy core.
+            Spin,
+            // As Block, but gives up, ending the enumeration, if nothing arrives within the timeout.
+            Timeout
+        };
+
+        // Pops elements off a BoundedQueue. Enumerating a queue consumes it, so concurrent enumerators share out
+        // the elements between them, and reset doesn't bring any back.
+        template <typename T>
+        class QueueEnumerator: public Enumerator<T>
+        {
+        public:
+            QueueEnumerator(std::shared_ptr<Concurrency::BoundedQueue<T> > queue, QueueWait wait, std::chrono::nanoseconds timeout)
+                : queue_(queue)
+                , wait_(wait)
+                , timeout_(timeout)
+                , current_()
+            {
+            }
+
+            QueueEnumerator(const QueueEnumerator& other)
+                : queue_(other.queue_)
+                , wait_(other.wait_)
+                , timeout_(other.timeout_)
+                , current_()
+            {
+            }
+
+            virtual ~QueueEnumerator(){}
+
+            QueueEnumerator& operator=(const QueueEnumerator& rhs)
+            {
+                queue_ = rhs.queue_;
+                wait_ = rhs.wait_;
+                timeout_ = rhs.timeout_;
+                current_.reset();
+                return *this;
+            }
+
+            virtual T& current_ref() override
+            {
+                return *current_;
+            }
+
+            virtual T current() const override
+            {
+                return copy_value(*current_);
+            }
+
+            virtual bool move_next() override
+            {
+                if (queue_->try_pop(current_))
+                {
+                    return true;
+                }
+
+                Concurrency::Backoff backoff(wait_ != QueueWait::Spin);
+                std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + timeout_;
+
+                while (!queue_->try_pop(current_))
+                {
+                    if (queue_->closed())
+                    {
+                        // Everything pushed before the queue was closed is visible now.
+                        if (queue_->try_pop(current_))
+                        {
+                            return true;
+                        }
+
+                        current_.reset();
+                        return false;
+                    }
+
+                    if (wait_ == QueueWait::Timeout && std::chrono::steady_clock::now() >= deadline)
+                    {
+                        current_.reset();
+                        return false;
+                    }
+
+                    backoff.wait();
+                }
+
+                return true;
+            }
+
+            virtual bool movable() const override
+            {
+                return true;
+            }
+
+            virtual void reset() override
+            {
+                current_.reset();
+            }
+
+        private:
+            std::shared_ptr<Concurrency::BoundedQueue<T> > queue_;
+            QueueWait wait_;
+            std::chrono::nanoseconds timeout_;
+            Optional<T> current_;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef LINQ_PLUSPLUS_RANDOM_ACCESS_H
+#define LINQ_PLUSPLUS_RANDOM_ACCESS_H
+
+#include <stddef.h>
+
+namespace LinqPlusPlus
+{
+    namespace Enumerators
+    {
+        // Implemented alongside Enumerator<T> by enumerators that know how many elements they hold and can jump to
+        // any of them directly, which lets count, element_at and skip avoid walking the sequence. Such enumerators
+        // return themselves from Enumerator::random_access, which is much cheaper than a cross cast.
+        class RandomAccess
+        {
+        public:
+            virtual ~RandomAccess(){};
+
+            virtual size_t size() const = 0;
+
+            // Positions the enumerator on the element at index, as if move_next had been called index + 1 times
+            // after a reset. Returns false, leaving the enumerator past the end, if there is no such element.
+            virtual bool seek(size_t index) = 0;
+        };
+    }
+}
+
+#endif
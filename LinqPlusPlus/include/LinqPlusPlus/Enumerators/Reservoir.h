@@ -0,0 +1,74 @@
+#ifndef LINQ_PLUSPLUS_RESERVOIR_H
+#define LINQ_PLUSPLUS_RESERVOIR_H
+
+#include "SampleRandom.h"
+#include <cmath>
+#include <limits>
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+namespace LinqPlusPlus
+{
+    namespace Enumerators
+    {
+        // A uniform sample of k elements from a sequence of unknown length, kept with Li's algorithm L. Once the
+        // reservoir is full the position of the next element to enter it is drawn directly, so the elements in
+        // between are passed over without a random number each, and a random access source can seek to it.
+        template <typename T>
+        class Reservoir
+        {
+        public:
+            Reservoir(size_t k, uint64_t seed)
+                : k_(k)
+                , random_(seed)
+                , weight_(1.0)
+                , next_(k == 0 ? std::numeric_limits<size_t>::max() : 0)
+            {
+            }
+
+            // The position in the sequence of the next element add expects, the largest size_t once no later
+            // element can be picked.
+            size_t next() const
+            {
+                return next_;
+            }
+
+            void add(T element)
+            {
+                if (elements_.size() < k_)
+                {
+                    elements_.push_back(std::move(element));
+                    if (elements_.size() < k_)
+                    {
+                        ++next_;
+                        return;
+                    }
+                }
+                else
+                {
+                    elements_[random_.below(k_)] = std::move(element);
+                }
+
+                weight_ *= std::exp(std::log(random_.uniform()) / k_);
+                size_t skip = random_.skip(std::log1p(-weight_));
+                next_ = skip < std::numeric_limits<size_t>::max() - next_ - 1 ? next_ + skip + 1 : std::numeric_limits<size_t>::max();
+            }
+
+            std::vector<T>& elements()
+            {
+                return elements_;
+            }
+
+        private:
+            size_t k_;
+            SampleRandom random_;
+            double weight_;
+            size_t next_;
+            std::vector<T> elements_;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef LINQ_PLUSPLUS_SAMPLE_RANDOM_H
+#define LINQ_PLUSPLUS_SAMPLE_RANDOM_H
+
+#include <cmath>
+#include <limits>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace LinqPlusPlus
+{
+    namespace Enumerators
+    {
+        // The splitmix64 generator behind sample and sample_fraction. Unlike the std distributions its output is
+        // the same on every platform, so a seed always picks the same elements.
+        class SampleRandom
+        {
+        public:
+            explicit SampleRandom(uint64_t seed)
+                : state_(seed)
+            {
+            }
+
+            uint64_t next()
+            {
+                uint64_t z = (state_ += 0x9E3779B97F4A7C15ULL);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+                return z ^ (z >> 31);
+            }
+
+            // Uniform in (0, 1], so its logarithm is finite.
+            double uniform()
+            {
+                return static_cast<double>((next() >> 11) + 1) / 9007199254740992.0;
+            }
+
+            // Uniform in [0, n).
+            size_t below(size_t n)
+            {
+                return static_cast<size_t>(static_cast<double>(next() >> 11) / 9007199254740992.0 * n);
+            }
+
+            // The number of elements to pass over before the next success of trials that each succeed with the
+            // probability whose complement has the given logarithm, or the largest size_t if it is beyond reach.
+            size_t skip(double logFailure)
+            {
+                double skip = std::floor(std::log(uniform()) / logFailure);
+                return skip >= 0.0 && skip < static_cast<double>(std::numeric_limits<size_t>::max() / 2)
+                    ? static_cast<size_t>(skip)
+                    : std::numeric_limits<size_t>::max();
+            }
+
+        private:
+            uint64_t state_;
+        };
+    }
+}
+
+#endif
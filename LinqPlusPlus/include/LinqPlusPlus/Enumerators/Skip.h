@@ -0,0 +1,136 @@
+#ifndef LINQ_PLUSPLUS_SKIP_H
+#define LINQ_PLUSPLUS_SKIP_H
+
+#include "Enumerator.h"
+#include "RandomAccess.h"
+#include <memory>
+
+namespace LinqPlusPlus
+{
+    namespace Enumerators
+    {
+        // Passes over the first count elements of the source. When the source supports random access the elements
+        // are jumped over with a single seek instead of being enumerated, and the rest stay random access.
+        template <typename T>
+        class Skip: public Enumerator<T>, public RandomAccess
+        {
+        public:
+            Skip(std::shared_ptr<Enumerator<T> > source, RandomAccess* random, size_t count)
+                : source_(source)
+                , random_(random)
+                , count_(count)
+                , isReset_(true)
+            {
+            }
+
+            Skip(const Skip& other)
+                : source_(other.source_)
+                , random_(other.random_)
+                , count_(other.count_)
+                , isReset_(other.isReset_)
+            {
+            }
+
+            virtual ~Skip(){}
+
+            Skip& operator=(const Skip& rhs)
+            {
+                source_ = rhs.source_;
+                random_ = rhs.random_;
+                count_ = rhs.count_;
+                isReset_ = rhs.isReset_;
+
+                return *this;
+            }
+
+            virtual T& current_ref() override
+            {
+                return source_->current_ref();
+            }
+
+            virtual T current() const override
+            {
+                return source_->current();
+            }
+
+            virtual bool move_next() override
+            {
+                if (!isReset_)
+                {
+                    return source_->move_next();
+                }
+
+                isReset_ = false;
+
+                if (random_ != nullptr)
+                {
+                    return random_->seek(count_);
+                }
+
+                for (size_t i = 0; i < count_; ++i)
+                {
+                    if (!source_->move_next())
+                    {
+                        return false;
+                    }
+                }
+
+                return source_->move_next();
+            }
+
+            virtual bool movable() const override
+            {
+                return source_->movable();
+            }
+
+            virtual void reset() override
+            {
+                source_->reset();
+                isReset_ = true;
+            }
+
+            virtual bool push(const std::function<bool(T&)>& sink) override
+            {
+                if (!isReset_)
+                {
+                    return source_->push(sink);
+                }
+
+                isReset_ = false;
+
+                if (random_ != nullptr)
+                {
+                    return !random_->seek(count_) || (sink(source_->current_ref()) && source_->push(sink));
+                }
+
+                size_t skipped = 0;
+                return source_->push([&](T& t){ return skipped++ < count_ || sink(t); });
+            }
+
+            virtual RandomAccess* random_access() override
+            {
+                return random_ != nullptr ? this : nullptr;
+            }
+
+            virtual size_t size() const override
+            {
+                size_t size = random_->size();
+                return size > count_ ? size - count_ : 0;
+            }
+
+            virtual bool seek(size_t index) override
+            {
+                isReset_ = false;
+                return random_->seek(count_ + index);
+            }
+
+        private:
+            std::shared_ptr<Enumerator<T> > source_;
+            RandomAccess* random_;
+            size_t count_;
+            bool isReset_;
+        };
+    }
+}
+
+#endif
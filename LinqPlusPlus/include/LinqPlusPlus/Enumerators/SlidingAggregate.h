@@ -0,0 +1,126 @@
+#ifndef LINQ_PLUSPLUS_SLIDING_AGGREGATE_H
+#define LINQ_PLUSPLUS_SLIDING_AGGREGATE_H
+
+#include "Enumerator.h"
+#include <deque>
+#include <functional>
+#include <memory>
+
+namespace LinqPlusPlus
+{
+    namespace Enumerators
+    {
+        // An invertible aggregate, such as a sum, over each window of size consecutive source elements, starting a new
+        // window every step elements. The aggregate is kept up to date as the window slides, adding each element as
+        // it enters and removing it as it leaves, so each element costs O(1) whatever the size of the window.
+        template <typename T, typename TAccumulate>
+        class SlidingAggregate: public Enumerator<TAccumulate>
+        {
+        public:
+            SlidingAggregate(std::shared_ptr<Enumerator<T> > source, size_t size, size_t step, const TAccumulate& seed,
+                             std::function<TAccumulate (const TAccumulate&, const T&)> add,
+                             std::function<TAccumulate (const TAccumulate&, const T&)> remove)
+                : source_(source)
+                , size_(size)
+                , step_(step)
+                , seed_(seed)
+                , add_(add)
+                , remove_(remove)
+                , seen_(0)
+                , accumulated_(seed)
+                , current_(seed)
+            {
+            }
+
+            SlidingAggregate(const SlidingAggregate& other)
+                : source_(other.source_)
+                , size_(other.size_)
+                , step_(other.step_)
+                , seed_(other.seed_)
+                , add_(other.add_)
+                , remove_(other.remove_)
+                , window_(other.window_)
+                , seen_(other.seen_)
+                , accumulated_(other.accumulated_)
+                , current_(other.current_)
+            {
+            }
+
+            virtual ~SlidingAggregate(){}
+
+            SlidingAggregate& operator=(const SlidingAggregate& rhs)
+            {
+                source_ = rhs.source_;
+                size_ = rhs.size_;
+                step_ = rhs.step_;
+                seed_ = rhs.seed_;
+                add_ = rhs.add_;
+                remove_ = rhs.remove_;
+                window_ = rhs.window_;
+                seen_ = rhs.seen_;
+                accumulated_ = rhs.accumulated_;
+                current_ = rhs.current_;
+
+                return *this;
+            }
+
+            virtual TAccumulate& current_ref() override
+            {
+                return current_;
+            }
+
+            virtual TAccumulate current() const override
+            {
+                return current_;
+            }
+
+            virtual bool move_next() override
+            {
+                while (source_->move_next())
+                {
+                    T& element = source_->current_ref();
+                    accumulated_ = add_(accumulated_, element);
+                    window_.push_back(copy_value(element));
+                    ++seen_;
+
+                    if (window_.size() > size_)
+                    {
+                        accumulated_ = remove_(accumulated_, window_.front());
+                        window_.pop_front();
+                    }
+
+                    if (seen_ >= size_ && (seen_ - size_) % step_ == 0)
+                    {
+                        current_ = accumulated_;
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            virtual void reset() override
+            {
+                source_->reset();
+                window_.clear();
+                seen_ = 0;
+                accumulated_ = seed_;
+                current_ = seed_;
+            }
+
+        private:
+            std::shared_ptr<Enumerator<T> > source_;
+            size_t size_;
+            size_t step_;
+            TAccumulate seed_;
+            std::function<TAccumulate (const TAccumulate&, const T&)> add_;
+            std::function<TAccumulate (const TAccumulate&, const T&)> remove_;
+            std::deque<T> window_;
+            size_t seen_;
+            TAccumulate accumulated_;
+            TAccumulate current_;
+        };
+    }
+}
+
+#endif
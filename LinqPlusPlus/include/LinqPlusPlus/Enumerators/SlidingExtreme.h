@@ -0,0 +1,115 @@
+#ifndef LINQ_PLUSPLUS_SLIDING_EXTREME_H
+#define LINQ_PLUSPLUS_SLIDING_EXTREME_H
+
+#include "Enumerator.h"
+#include <deque>
+#include <functional>
+#include <memory>
+#include <utility>
+
+namespace LinqPlusPlus
+{
+    namespace Enumerators
+    {
+        // The minimum (or maximum) of each window of size consecutive source elements, starting a new window every
+        // step elements. Min and max can't be undone when an element leaves the window, so instead of an aggregate
+        // this keeps a monotonic deque: the elements that could still become the extreme of a later window, in
+        // source order, with the current extreme at the front. Each element is pushed and popped at most once.
+        template <typename T>
+        class SlidingExtreme: public Enumerator<T>
+        {
+        public:
+            // before(x, y) is true if x is the more extreme of the two, e.g. x < y for the minimum.
+            SlidingExtreme(std::shared_ptr<Enumerator<T> > source, size_t size, size_t step, std::function<bool(const T&, const T&)> before)
+                : source_(source)
+                , size_(size)
+                , step_(step)
+                , before_(before)
+                , seen_(0)
+            {
+            }
+
+            SlidingExtreme(const SlidingExtreme& other)
+                : source_(other.source_)
+                , size_(other.size_)
+                , step_(other.step_)
+                , before_(other.before_)
+                , candidates_(other.candidates_)
+                , seen_(other.seen_)
+            {
+            }
+
+            virtual ~SlidingExtreme(){}
+
+            SlidingExtreme& operator=(const SlidingExtreme& rhs)
+            {
+                source_ = rhs.source_;
+                size_ = rhs.size_;
+                step_ = rhs.step_;
+                before_ = rhs.before_;
+                candidates_ = rhs.candidates_;
+                seen_ = rhs.seen_;
+
+                return *this;
+            }
+
+            virtual T& current_ref() override
+            {
+                return candidates_.front().second;
+            }
+
+            virtual T current() const override
+            {
+                return copy_value(candidates_.front().second);
+            }
+
+            virtual bool move_next() override
+            {
+                while (source_->move_next())
+                {
+                    T& element = source_->current_ref();
+
+                    // Anything no more extreme than the new element, and older, can never be the extreme again.
+                    while (!candidates_.empty() && !before_(candidates_.back().second, element))
+                    {
+                        candidates_.pop_back();
+                    }
+
+                    candidates_.push_back(std::pair<size_t, T>(seen_, copy_value(element)));
+                    ++seen_;
+
+                    if (candidates_.front().first + size_ < seen_)
+                    {
+                        candidates_.pop_front();
+                    }
+
+                    if (seen_ >= size_ && (seen_ - size_) % step_ == 0)
+                    {
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            virtual void reset() override
+            {
+                source_->reset();
+                candidates_.clear();
+                seen_ = 0;
+            }
+
+        private:
+            std::shared_ptr<Enumerator<T> > source_;
+            size_t size_;
+            size_t step_;
+            std::function<bool(const T&, const T&)> before_;
+
+            // Source positions and values, from the current extreme to the newest element.
+            std::deque<std::pair<size_t, T> > candidates_;
+            size_t seen_;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef LINQ_PLUSPLUS_SLIDING_WINDOW_H
+#define LINQ_PLUSPLUS_SLIDING_WINDOW_H
+
+#include "Enumerator.h"
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace LinqPlusPlus
+{
+    namespace Enumerators
+    {
+        // The elements of each window of size consecutive source elements, starting a new window every step
+        // elements. Only full windows are produced, so a source shorter than size gives none.
+        template <typename T>
+        class SlidingWindow: public Enumerator<std::vector<T> >
+        {
+        public:
+            SlidingWindow(std::shared_ptr<Enumerator<T> > source, size_t size, size_t step)
+                : source_(source)
+                , size_(size)
+                , step_(step)
+                , seen_(0)
+            {
+            }
+
+            SlidingWindow(const SlidingWindow& other)
+                : source_(other.source_)
+                , size_(other.size_)
+                , step_(other.step_)
+                , window_(other.window_)
+                , seen_(other.seen_)
+                , current_(other.current_)
+            {
+            }
+
+            virtual ~SlidingWindow(){}
+
+            SlidingWindow& operator=(const SlidingWindow& rhs)
+            {
+                source_ = rhs.source_;
+                size_ = rhs.size_;
+                step_ = rhs.step_;
+                window_ = rhs.window_;
+                seen_ = rhs.seen_;
+                current_ = rhs.current_;
+
+                return *this;
+            }
+
+            virtual std::vector<T>& current_ref() override
+            {
+                return current_;
+            }
+
+            virtual std::vector<T> current() const override
+            {
+                return current_;
+            }
+
+            virtual bool move_next() override
+            {
+                while (source_->move_next())
+                {
+                    window_.push_back(copy_value(source_->current_ref()));
+                    ++seen_;
+
+                    if (window_.size() > size_)
+                    {
+                        window_.pop_front();
+                    }
+
+                    if (seen_ >= size_ && (seen_ - size_) % step_ == 0)
+                    {
+                        current_.assign(window_.begin(), window_.end());
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            virtual void reset() override
+            {
+                source_->reset();
+                window_.clear();
+                seen_ = 0;
+                current_.clear();
+            }
+
+        private:
+            std::shared_ptr<Enumerator<T> > source_;
+            size_t size_;
+            size_t step_;
+            std::deque<T> window_;
+            size_t seen_;
+            std::vector<T> current_;
+        };
+    }
+}
+
+#endif
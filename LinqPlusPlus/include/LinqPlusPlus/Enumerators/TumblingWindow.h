@@ -0,0 +1,141 @@
+#ifndef LINQ_PLUSPLUS_TUMBLING_WINDOW_H
+#define LINQ_PLUSPLUS_TUMBLING_WINDOW_H
+
+#include "Enumerator.h"
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <stdint.h>
+#include <type_traits>
+#include <vector>
+
+namespace LinqPlusPlus
+{
+    namespace Enumerators
+    {
+        // Which window of the given length a time falls in, counting from time zero (the clock's epoch for time
+        // points), rounding down so negative times work too.
+        template <typename TTime>
+        int64_t window_index(TTime time, TTime length, std::true_type /* integral */)
+        {
+            int64_t index = static_cast<int64_t>(time / length);
+            return (time % length != 0 && (time < 0) != (length < 0)) ? index - 1 : index;
+        }
+
+        template <typename TTime>
+        int64_t window_index(TTime time, TTime length, std::false_type /* integral */)
+        {
+            return static_cast<int64_t>(std::floor(time / length));
+        }
+
+        template <typename TTime>
+        int64_t window_index(TTime time, TTime length)
+        {
+            return window_index(time, length, std::is_integral<TTime>());
+        }
+
+        template <typename Clock, typename Duration, typename Rep, typename Period>
+        int64_t window_index(const std::chrono::time_point<Clock, Duration>& time, const std::chrono::duration<Rep, Period>& length)
+        {
+            typedef typename std::common_type<Duration, std::chrono::duration<Rep, Period> >::type Common;
+            return window_index(Common(time.time_since_epoch()).count(), Common(length).count());
+        }
+
+        // Splits the source into runs of consecutive elements that fall in the same window, as given by windowOf,
+        // producing the elements of each run. The source is expected to be in time order: an element from another
+        // window closes the current one, even if a later element falls back in it.
+        template <typename T>
+        class TumblingWindow: public Enumerator<std::vector<T> >
+        {
+        public:
+            TumblingWindow(std::shared_ptr<Enumerator<T> > source, std::function<int64_t(const T&)> windowOf)
+                : source_(source)
+                , windowOf_(windowOf)
+                , window_(0)
+            {
+            }
+
+            TumblingWindow(const TumblingWindow& other)
+                : source_(other.source_)
+                , windowOf_(other.windowOf_)
+                , pending_(other.pending_)
+                , window_(other.window_)
+                , current_(other.current_)
+            {
+            }
+
+            virtual ~TumblingWindow(){}
+
+            TumblingWindow& operator=(const TumblingWindow& rhs)
+            {
+                source_ = rhs.source_;
+                windowOf_ = rhs.windowOf_;
+                pending_ = rhs.pending_;
+                window_ = rhs.window_;
+                current_ = rhs.current_;
+
+                return *this;
+            }
+
+            virtual std::vector<T>& current_ref() override
+            {
+                return current_;
+            }
+
+            virtual std::vector<T> current() const override
+            {
+                return current_;
+            }
+
+            virtual bool move_next() override
+            {
+                while (source_->move_next())
+                {
+                    T& element = source_->current_ref();
+                    int64_t window = windowOf_(element);
+
+                    if (!pending_.empty() && window != window_)
+                    {
+                        current_.swap(pending_);
+                        pending_.clear();
+                        pending_.push_back(copy_value(element));
+                        window_ = window;
+                        return true;
+                    }
+
+                    pending_.push_back(copy_value(element));
+                    window_ = window;
+                }
+
+                if (pending_.empty())
+                {
+                    return false;
+                }
+
+                current_.swap(pending_);
+                pending_.clear();
+                return true;
+            }
+
+            virtual void reset() override
+            {
+                source_->reset();
+                pending_.clear();
+                current_.clear();
+            }
+
+        private:
+            std::shared_ptr<Enumerator<T> > source_;
+            std::function<int64_t(const T&)> windowOf_;
+
+            // The elements read so far of the window that's still open, and its index.
+            std::vector<T> pending_;
+            int64_t window_;
+
+            std::vector<T> current_;
+        };
+    }
+}
+
+#endif
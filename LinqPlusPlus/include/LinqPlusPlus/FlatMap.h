@@ -0,0 +1,168 @@
+#ifndef LINQ_PLUSPLUS_FLAT_MAP_H
+#define LINQ_PLUSPLUS_FLAT_MAP_H
+
+#include <functional>
+#include <stddef.h>
+#include <stdexcept>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+namespace LinqPlusPlus
+{
+    // A hash map made by IEnumerable::to_flat_map that keeps its entries in one vector, in the order they were
+    // inserted, and finds them through an open addressing table of indices into it with linear probing. Neither
+    // allocates per entry, and iterating walks the vector.
+    template <typename TKey, typename TValue, typename THash = std::hash<TKey> >
+    class FlatMap
+    {
+    public:
+        typedef std::pair<TKey, TValue> value_type;
+        typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+        FlatMap()
+            : shift_(64)
+        {
+        }
+
+        explicit FlatMap(size_t capacity)
+            : shift_(64)
+        {
+            reserve(capacity);
+        }
+
+        // Makes room for count entries without rehashing.
+        void reserve(size_t count)
+        {
+            entries_.reserve(count);
+
+            if (count * 2 > slots_.size())
+            {
+                rehash(count);
+            }
+        }
+
+        // Adds key with value unless key is already there, in which case it returns false and keeps the first value.
+        bool insert(TKey key, TValue value)
+        {
+            if ((entries_.size() + 1) * 2 > slots_.size())
+            {
+                rehash(entries_.size() + 1);
+            }
+
+            size_t slot = slot_of(key);
+            if (slots_[slot] != vacant())
+            {
+                return false;
+            }
+
+            slots_[slot] = entries_.size();
+            entries_.push_back(value_type(std::move(key), std::move(value)));
+            return true;
+        }
+
+        TValue* find(const TKey& key)
+        {
+            size_t index = index_of(key);
+            return index == vacant() ? nullptr : &entries_[index].second;
+        }
+
+        const TValue* find(const TKey& key) const
+        {
+            size_t index = index_of(key);
+            return index == vacant() ? nullptr : &entries_[index].second;
+        }
+
+        bool contains(const TKey& key) const
+        {
+            return index_of(key) != vacant();
+        }
+
+        const TValue& at(const TKey& key) const
+        {
+            const TValue* value = find(key);
+            if (value == nullptr)
+            {
+                throw std::out_of_range("key is not in the map");
+            }
+
+            return *value;
+        }
+
+        size_t size() const
+        {
+            return entries_.size();
+        }
+
+        bool empty() const
+        {
+            return entries_.empty();
+        }
+
+        const_iterator begin() const
+        {
+            return entries_.begin();
+        }
+
+        const_iterator end() const
+        {
+            return entries_.end();
+        }
+
+    private:
+        static size_t vacant()
+        {
+            return static_cast<size_t>(-1);
+        }
+
+        // Fibonacci hashing spreads keys whose std::hash is the identity, like integers, over the whole table.
+        size_t home_of(const TKey& key) const
+        {
+            return static_cast<size_t>((static_cast<uint64_t>(hash_(key)) * 0x9E3779B97F4A7C15ULL) >> shift_);
+        }
+
+        // The slot holding key, or the empty slot it would go in.
+        size_t slot_of(const TKey& key) const
+        {
+            size_t mask = slots_.size() - 1;
+            size_t slot = home_of(key);
+
+            while (slots_[slot] != vacant() && !(entries_[slots_[slot]].first == key))
+            {
+                slot = (slot + 1) & mask;
+            }
+
+            return slot;
+        }
+
+        size_t index_of(const TKey& key) const
+        {
+            return slots_.empty() ? vacant() : slots_[slot_of(key)];
+        }
+
+        // Grows the table to a power of two at least twice count, so probe sequences stay short.
+        void rehash(size_t count)
+        {
+            unsigned bits = 1;
+            while ((static_cast<size_t>(1) << bits) < count * 2)
+            {
+                ++bits;
+            }
+
+            shift_ = 64 - bits;
+            slots_.assign(static_cast<size_t>(1) << bits, vacant());
+
+            for (size_t i = 0; i < entries_.size(); ++i)
+            {
+                slots_[slot_of(entries_[i].first)] = i;
+            }
+        }
+
+        std::vector<value_type> entries_;
+        std::vector<size_t> slots_;
+        unsigned shift_;
+        THash hash_;
+    };
+}
+
+#endif
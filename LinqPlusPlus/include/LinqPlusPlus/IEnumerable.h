@@ -1,15 +1,51 @@
 #ifndef LINQ_PLUSPLUS_IENUMERABLE_H
 #define LINQ_PLUSPLUS_IENUMERABLE_H
 
-#include "Enumerators/ArrayEnumerator.h"
+#include "Aggregators.h"
+#include "Enumerators/ArithmeticSequence.h"
+#include "Enumerators/AsyncBoundary.h"
+#include "Enumerators/BernoulliSample.h"
 #include "Enumerators/Combine.h"
+#include "Enumerators/ContainerEnumerator.h"
+#include "Enumerators/Consume.h"
+#include "Enumerators/DefaultIfEmpty.h"
+#include "Enumerators/Deferred.h"
+#include "Enumerators/ExternalGroup.h"
+#include "Enumerators/ExternalSort.h"
 #include "Enumerators/Filter.h"
+#include "Enumerators/Instrumented.h"
 #include "Enumerators/Map.h"
+#include "Enumerators/MemoEnumerator.h"
+#include "Enumerators/RandomAccess.h"
+#include "Enumerators/Reservoir.h"
+#include "Enumerators/Skip.h"
+#include "Enumerators/SlidingAggregate.h"
+#include "Enumerators/SlidingExtreme.h"
+#include "Enumerators/SlidingWindow.h"
+#include "Enumerators/TumblingWindow.h"
+#include "FlatMap.h"
+#include "IncrementalAggregate.h"
+#include "IncrementalGroupedAggregate.h"
+#include "Lookup.h"
+#include "Optional.h"
+#include "Sketches/HyperLogLog.h"
+#include "Sketches/KllSketch.h"
+#include <algorithm>
+#include <cmath>
+#include <deque>
 #include <functional>
+#include <iterator>
+#include <list>
 #include <map>
+#include <memory>
+#include <stddef.h>
 #include <stdexcept>
 #include <stdint.h>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #define ENUMERABLE_PTR(__T) std::shared_ptr<IEnumerable< __T > >
 
@@ -17,32 +53,96 @@ namespace LinqPlusPlus
 {
     template <typename T> class Iterator;
 
+    template <typename T> class IndexedRange;
+
     template <typename T> class GenericEnumerable;
 
+    template <typename T, typename TKey> class IndexedEnumerable;
+
+    template <typename T> class DictionaryColumn;
+
+    template <typename T>
+    using EnumeratorFactory = std::function<std::shared_ptr<Enumerator<T> > ()>;
+
+    // The type of enumerator an enumerable makes, where the operator that follows can fuse with it. Recorded when
+    // the enumerable is built, so operators can decide without making an enumerator.
+    enum class Fusable
+    {
+        None,
+        Filter,
+        Projection
+    };
+
+    // Enumerables are immutable descriptions of a query. Every call to enumerator(), and so every begin() and every
+    // terminal operator, gets a new enumerator with its own state, so one query can be enumerated by many threads
+    // at once, or from inside one of its own predicates, without locking.
     template <typename T>
-    class IEnumerable
+    class IEnumerable : public std::enable_shared_from_this<IEnumerable<T> >
     {
     public:
         typedef Iterator<T> iterator;
 
         virtual ~IEnumerable(){};
 
-        virtual Enumerator<T>& enumerator(bool initialize = true) = 0;
+        // Creates an enumerator positioned before the first element.
+        virtual std::shared_ptr<Enumerator<T> > enumerator() const = 0;
 
-        iterator begin()
+#ifdef LINQ_PLUSPLUS_INSTRUMENTATION
+        virtual Diagnostics::OperatorStatistics::Ptr statistics() const = 0;
+#endif
+
+        iterator begin() const
         {
-            Enumerator<T>& e = enumerator();
-            e.move_next();
+            return iterator(enumerator());
+        }
 
-            Iterator<T> iter = Iterator<T>(e);
-            
-            return static_cast<iterator>(iter);
+        iterator end() const
+        {
+            return iterator();
+        }
+
+        // True if the elements can be reached by index, in which case indexed() gives random access iterators.
+        bool has_random_access() const
+        {
+            return enumerator()->random_access() != nullptr;
         }
 
-        iterator end()
+        // The elements as a sized range of random access iterators, which can be handed to the standard algorithms,
+        // including the ones taking an execution policy, and to the C++20 range algorithms, without materializing
+        // the sequence. Available for ranges, sequences, vectors, deques and arrays, and for select and skip over them.
+        IndexedRange<T> indexed() const
         {
-            Iterator<T> iter = Iterator<T>(enumerator(false), true);
-            return static_cast<iterator>(iter);
+            static_assert(std::is_copy_constructible<T>::value, "Indexed iterators return elements by value, which must be copyable");
+            std::shared_ptr<Enumerator<T> > e = enumerator();
+            Enumerators::RandomAccess* random = e->random_access();
+
+            if (random == nullptr)
+            {
+                throw std::runtime_error("Invalid operation: the sequence does not support random access");
+            }
+
+            return IndexedRange<T>(this->shared_from_this(), random->size());
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Lets the predicates fused into the where clause this ends in be reordered by observed cost and
+        // selectivity; see Filter::adaptive. onReorder, if given, is called with each sampling window's statistics,
+        // in the new evaluation order, whenever an enumeration of the query reorders them.
+        ENUMERABLE_PTR(T) adaptive(size_t sampleSize = 4096, size_t resampleInterval = 1 << 16,
+                                   typename Enumerators::Filter<T>::Observer onReorder = nullptr)
+        {
+            if (fusable() != Fusable::Filter)
+            {
+                throw std::runtime_error("Invalid operation: adaptive predicate ordering requires a where clause");
+            }
+
+            ENUMERABLE_PTR(T) source = this->shared_from_this();
+            return fuse<T>("adaptive", [=]()
+            {
+                std::shared_ptr<Enumerator<T> > e = Enumerators::unwrap(source->enumerator());
+                static_cast<Enumerators::Filter<T>&>(*e).adaptive(sampleSize, resampleInterval, onReorder);
+                return e;
+            }, Fusable::Filter);
         }
 
         ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -53,16 +153,16 @@ namespace LinqPlusPlus
                 throw std::runtime_error("An accumulator function is required");
             }
 
-            Enumerator<T>& enumerator = this->enumerator();
+            std::shared_ptr<Enumerator<T> > e = enumerator();
 
-            if (!enumerator.move_next())
+            if (!e->move_next())
             {
                 throw std::runtime_error("can't aggregate an empty collection");
             }
 
-            T first = enumerator.current();
+            T first = take(e->current_ref(), is_consuming(*e));
 
-            return fold(enumerator, first, accumulator);
+            return fold(*e, first, accumulator);
         }
 
         ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -74,7 +174,7 @@ namespace LinqPlusPlus
                 throw std::runtime_error("An accumulator function is required");
             }
 
-            return fold(enumerator(), seed, accumulator);
+            return fold(*enumerator(), seed, accumulator);
         }
 
         ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -87,6 +187,28 @@ namespace LinqPlusPlus
             return resultSelector(accumulated);
         }
 
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Evaluates several Aggregators in one pass and returns their results as a tuple, e.g.
+        // aggregate_many(Aggregators::count(), Aggregators::sum(), Aggregators::max()). Over arrays and vectors each
+        // accumulator folds a block of elements at a time while it is in cache.
+        template <typename... TAggregators>
+        typename Aggregators::Many<T, TAggregators...>::result_type aggregate_many(TAggregators... aggregators)
+        {
+            const size_t blockSize = 1024;
+            Aggregators::Many<T, TAggregators...> many(aggregators...);
+
+            enumerator()->push_blocks([&](T* elements, size_t size)
+            {
+                for (size_t i = 0; i < size; i += blockSize)
+                {
+                    many.add(elements + i, std::min(blockSize, size - i));
+                }
+                return true;
+            });
+
+            return many.result();
+        }
+
         ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
         bool all(std::function<bool(const T&)> predicate)
         {
@@ -95,13 +217,8 @@ namespace LinqPlusPlus
                 throw std::runtime_error("A predicate is required");
             }
 
-            Enumerator<T>& enumerator = this->enumerator();
-
             bool success = true;
-            while (success && enumerator.move_next())
-            {
-                success = predicate(enumerator.current_ref());
-            }
+            enumerator()->push([&](T& t){ return success = predicate(t); });
 
             return success;
         }
@@ -109,7 +226,7 @@ namespace LinqPlusPlus
         ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
         bool any()
         {
-            return enumerator().move_next();
+            return enumerator()->move_next();
         }
 
         ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -120,17 +237,64 @@ namespace LinqPlusPlus
                 throw std::runtime_error("A predicate is required");
             }
 
-            Enumerator<T>& enumerator = this->enumerator();
+            std::shared_ptr<Enumerator<T> > e = enumerator();
 
             bool found = false;
-            while (!found && enumerator.move_next())
+            while (!found && e->move_next())
             {
-                found = predicate(enumerator.current_ref());
+                found = predicate(e->current_ref());
             }
 
             return found;
         }
 
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Estimates distinct().count() with a HyperLogLog sketch, in 2^precision bytes rather than a map of every
+        // distinct element. Elements are hashed with std::hash. See Sketches::HyperLogLog for the error.
+        size_t approx_count_distinct(unsigned precision = 14)
+        {
+            return static_cast<size_t>(std::llround(distinct_sketch(precision).estimate()));
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Estimates the element below which the given percentage of elements fall, from a KLL sketch of about k
+        // elements. See Sketches::KllSketch for the error.
+        T approx_percentile(double percentile, size_t k = 200)
+        {
+            if (!(percentile >= 0.0 && percentile <= 100.0))
+            {
+                throw std::out_of_range("A percentile must be between 0 and 100");
+            }
+
+            return quantile_sketch(k).quantile(percentile / 100.0);
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // As approx_percentile, for any number of quantiles between 0 and 1 from a single pass.
+        std::vector<T> approx_quantiles(const std::vector<double>& quantiles, size_t k = 200)
+        {
+            return quantile_sketch(k).quantiles(quantiles);
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Runs everything before the boundary on a worker thread, up to capacity elements ahead of the operators after
+        // it, so that an expensive stage overlaps with the work done downstream. Each enumeration gets its own worker.
+        // Behind consume(), the elements are moved to the operators after the boundary instead of copied.
+        ENUMERABLE_PTR(T) async_boundary(size_t capacity = 1024)
+        {
+            if (capacity == 0)
+            {
+                throw std::runtime_error("A capacity greater than zero is required");
+            }
+
+            ENUMERABLE_PTR(T) source = this->shared_from_this();
+            return chain<T>("async_boundary", [=]()
+            {
+                std::shared_ptr<Enumerator<T> > e = source->enumerator();
+                return std::make_shared<Enumerators::AsyncBoundary<T> >(e, capacity, is_consuming(*e));
+            });
+        }
+
         ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
         double average(std::function<double(const T&)> selector)
         {
@@ -195,28 +359,72 @@ namespace LinqPlusPlus
         template <typename U>
         ENUMERABLE_PTR(U) cast()
         {
-            auto castOp = [](const T& t){ return static_cast<U>(t); };
-            auto e = std::shared_ptr<Enumerator<U> >(new Enumerators::Map<T, U>(enumerator(), castOp));
-            return std::shared_ptr<IEnumerable<U> >(new GenericEnumerable<U>(e));
+            return select<U>([](const T& t){ return static_cast<U>(t); });
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Materializes the sequence and each element's key once, for repeated point and range lookups by key that
+        // don't scan it; see IndexedEnumerable.
+        template <typename TKey>
+        std::shared_ptr<IndexedEnumerable<T, TKey> > build_index(std::function<TKey(const T&)> keySelector)
+        {
+            if (keySelector == nullptr)
+            {
+                throw std::runtime_error("A key selector is required");
+            }
+
+            std::vector<T> elements;
+            materialize(*enumerator(), elements);
+
+            return std::make_shared<IndexedEnumerable<T, TKey> >(std::move(elements), keySelector);
         }
 
         ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
         ENUMERABLE_PTR(T) concat(ENUMERABLE_PTR(T) other)
         {
-            auto e = std::shared_ptr<Enumerator<T> >(new Enumerators::Combine<T>(enumerator(), other->enumerator()));
-            return ENUMERABLE_PTR(T)(new GenericEnumerable<T>(e));
+            ENUMERABLE_PTR(T) source = this->shared_from_this();
+            return chain<T>("concat", [=]()
+            {
+                return std::make_shared<Enumerators::Combine<T> >(source->enumerator(), other->enumerator());
+            }, other.get());
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Lets the terminal operator that follows move the elements out instead of copying them, where they belong to
+        // the query: a container handed to Enumerable::from by rvalue, or what operators like select and order_by
+        // make. Elements of a container the caller lent or shares are still copied.
+        ENUMERABLE_PTR(T) consume()
+        {
+            ENUMERABLE_PTR(T) source = this->shared_from_this();
+            return chain<T>("consume", [=]()
+            {
+                return std::make_shared<Enumerators::Consume<T> >(source->enumerator());
+            });
         }
 
         ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
         bool contains(const T& value)
         {
-            return any([&](const T& t){ return t == value; });
+            std::function<bool(const T&)> equal = [&](const T& t){ return t == value; };
+            ENUMERABLE_PTR(T) candidates = candidates_equal_to(value);
+
+            return candidates ? candidates->any(equal) : any(equal);
         }
 
         ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
         size_t count()
         {
-            return aggregate<size_t>(0, [](const size_t& acc, const T&){ return acc + 1; });
+            std::shared_ptr<Enumerator<T> > e = enumerator();
+
+            if (auto sized = e->random_access())
+            {
+                return sized->size();
+            }
+
+            size_t count = 0;
+            e->push([&](T&){ ++count; return true; });
+
+            return count;
         }
 
         ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -234,133 +442,193 @@ namespace LinqPlusPlus
         ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
         ENUMERABLE_PTR(T) default_if_empty(const T& defaultValue)
         {
-            if (any())
+            ENUMERABLE_PTR(T) source = this->shared_from_this();
+            return chain<T>("default_if_empty", [=]()
             {
-                std::shared_ptr<Enumerator<T> > e(new Enumerators::Map<T, T>(enumerator(), [](const T& t){ return t; }));
-                return ENUMERABLE_PTR(T)(new GenericEnumerable<T>(e));
-            }
-
-            T singleton[] = { defaultValue };
-            
-            auto e = std::shared_ptr<Enumerator<T> >(new Enumerators::ArrayEnumerator<T>(singleton, sizeof(singleton) / sizeof(int)));
-            return ENUMERABLE_PTR(T)(new GenericEnumerable<T>(e));
+                return std::make_shared<Enumerators::DefaultIfEmpty<T> >(source->enumerator(), defaultValue);
+            });
         }
 
         ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
-        ENUMERABLE_PTR(T) distinct()
+        // Stores each distinct element once and each position as a code into those, for grouping and filtering
+        // low cardinality values such as strings on the codes; see DictionaryColumn.
+        std::shared_ptr<DictionaryColumn<T> > dictionary_encode()
         {
-            std::shared_ptr<std::map<T, T> > distinctValues(new std::map<T, T>);
+            std::shared_ptr<Enumerator<T> > e = enumerator();
+            bool consuming = is_consuming(*e);
+
+            FlatMap<T, uint32_t> index;
+            std::vector<T> dictionary;
+            std::vector<uint32_t> codes;
+            codes.reserve(size_hint(*e));
 
-            auto filter = [=](const T& t)
-            {       
-                if (distinctValues->find(t) != distinctValues->end())
+            e->push([&](T& element)
+            {
+                const uint32_t* code = index.find(element);
+                if (code != nullptr)
                 {
-                    return false;
+                    codes.push_back(*code);
+                    return true;
                 }
 
-                distinctValues->insert(std::pair<T, T>(t, t));
-                return true;
-            };
+                if (dictionary.size() == UINT32_MAX)
+                {
+                    throw std::runtime_error("Invalid operation: too many distinct values to encode");
+                }
 
-            auto e = std::shared_ptr<Enumerator<T> >(new Enumerators::Filter<T>(enumerator(), filter));
+                uint32_t added = static_cast<uint32_t>(dictionary.size());
+                index.insert(element, added);
+                dictionary.push_back(take(element, consuming));
+                codes.push_back(added);
+                return true;
+            });
 
-            return ENUMERABLE_PTR(T)(new GenericEnumerable<T>(e));
+            return std::make_shared<DictionaryColumn<T> >(std::move(dictionary), std::move(codes));
         }
 
         ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
-        T& element_at(const size_t index)
+        ENUMERABLE_PTR(T) distinct()
         {
-            Enumerator<T>& enumerator = this->enumerator();
-            
-            if (!enumerator.move_next())
+            if (ENUMERABLE_PTR(T) values = distinct_values())
             {
-                throw std::out_of_range("index is out of range");
+                return values;
             }
 
-            size_t i = 0;
-            while (i < index && enumerator.move_next())
+            ENUMERABLE_PTR(T) source = this->shared_from_this();
+            return chain<T>("distinct", [=]()
             {
-                ++i;
-            }
+                std::shared_ptr<std::map<T, T> > distinctValues(new std::map<T, T>);
+
+                auto filter = [=](const T& t)
+                {
+                    if (distinctValues->find(t) != distinctValues->end())
+                    {
+                        return false;
+                    }
+
+                    distinctValues->insert(std::pair<T, T>(t, t));
+                    return true;
+                };
+
+                return std::make_shared<Enumerators::Filter<T> >(source->enumerator(), filter);
+            });
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // The HyperLogLog sketch behind approx_count_distinct, which can be merged with sketches of other sequences,
+        // e.g. other chunks of the same one processed in parallel.
+        Sketches::HyperLogLog distinct_sketch(unsigned precision = 14)
+        {
+            Sketches::HyperLogLog sketch(precision);
+            enumerator()->push([&](T& element)
+            {
+                sketch.add(element);
+                return true;
+            });
+
+            return sketch;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        T element_at(const size_t index)
+        {
+            std::shared_ptr<Enumerator<T> > e = enumerator();
+            T* element = find_at(*e, index);
 
-            if (i < index)
+            if (element == nullptr)
             {
                 throw std::out_of_range("index is out of range");
             }
 
-            return enumerator.current_ref();
+            return take(*element, is_consuming(*e));
         }
 
         ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
         T element_at_or_default(const size_t index, const T& defaultValue)
         {
-            try
-            {
-                return element_at(index);
-            }
-            catch (std::out_of_range&)
-            {
-                return defaultValue;
-            }
+            return try_element_at(index).value_or(defaultValue);
         }
 
         ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
         ENUMERABLE_PTR(T) except(ENUMERABLE_PTR(T) excluded)
         {
-            auto excludedMap = excluded->template to_map<T>([](const T& t) { return t; });
+            ENUMERABLE_PTR(T) source = this->shared_from_this();
+            std::shared_ptr<const std::map<T, T> > excludedMap(
+                new std::map<T, T>(excluded->template to_map<T>([](const T& t) { return t; })));
 
             auto keepIfNotExcluded = [=](const T& t)
             {
-                return excludedMap.find(t) == excludedMap.end();
+                return excludedMap->find(t) == excludedMap->end();
             };
 
-            auto e = std::shared_ptr<Enumerator<T> >(new Enumerators::Filter<T>(enumerator(), keepIfNotExcluded));
-            return ENUMERABLE_PTR(T)(new GenericEnumerable<T>(e));
+            return chain<T>("except", [=]()
+            {
+                return std::make_shared<Enumerators::Filter<T> >(source->enumerator(), keepIfNotExcluded);
+            }, excluded.get());
         }
 
         ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
         ENUMERABLE_PTR(T) except(ENUMERABLE_PTR(T) excluded, std::function<bool(const T& x, const T& y)> equals)
         {
+            ENUMERABLE_PTR(T) source = this->shared_from_this();
+
             auto keepIfNotExcluded = [=](const T& element)
             {
                 return !excluded->any([&](const T& t){ return equals(element, t); });
             };
 
-            auto e = std::shared_ptr<Enumerator<T> >(new Enumerators::Filter<T>(enumerator(), keepIfNotExcluded));
-            return ENUMERABLE_PTR(T)(new GenericEnumerable<T>(e));
+            return chain<T>("except", [=]()
+            {
+                return std::make_shared<Enumerators::Filter<T> >(source->enumerator(), keepIfNotExcluded);
+            }, excluded.get());
         }
 
         ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
-        T& first()
+        std::string explain()
         {
-            try
-            {
-                return element_at(0);
-            }
-            catch (std::out_of_range&)
+#ifdef LINQ_PLUSPLUS_INSTRUMENTATION
+            return statistics()->explain();
+#else
+            return "explain() requires building with LINQ_PLUSPLUS_INSTRUMENTATION\n";
+#endif
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        void explain(const Diagnostics::OperatorStatistics::Visitor& exporter)
+        {
+#ifdef LINQ_PLUSPLUS_INSTRUMENTATION
+            statistics()->visit(exporter);
+#else
+            (void)exporter;
+#endif
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        T first()
+        {
+            std::shared_ptr<Enumerator<T> > e = enumerator();
+            T* element = find_at(*e, 0);
+
+            if (element == nullptr)
             {
                 throw std::runtime_error("Invalid operation: cannot take first from an empty collection");
             }
+
+            return take(*element, is_consuming(*e));
         }
 
         ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
-        T& first(std::function<bool(const T&)> predicate)
+        T first(std::function<bool(const T&)> predicate)
         {
-            if (predicate == nullptr)
-            {
-                throw std::runtime_error("Argument is null: A predicate is required");
-            }
+            std::shared_ptr<Enumerator<T> > e = enumerator();
+            T* element = find_first(*e, predicate);
 
-            Enumerator<T>& enumerator = this->enumerator();
-            while (enumerator.move_next())
+            if (element == nullptr)
             {
-                if (predicate(enumerator.current_ref()))
-                {
-                    return enumerator.current_ref();
-                }
+                throw std::runtime_error("Invalid operation: no elements in the collection satisfy the given predicate");
             }
 
-            throw std::runtime_error("Invalid operation: no elements in the collection satisfy the given predicate");
+            return take(*element, is_consuming(*e));
         }
 
         ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -372,173 +640,1381 @@ namespace LinqPlusPlus
         ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
         T first_or_default(std::function<bool(const T&)> predicate, const T& defaultValue)
         {
-            try
-            {
-                return first(predicate);
-            }
-            catch (std::runtime_error&)
-            {
-                return defaultValue;
-            }
+            return try_first(predicate).value_or(defaultValue);
         }
 
         ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
-        ENUMERABLE_PTR(T) where(std::function<bool(const T&)> predicate)
+        template <typename TKey>
+        std::shared_ptr<IEnumerable<std::pair<TKey, std::vector<T> > > > group_by(std::function<TKey(const T&)> keySelector)
         {
-            auto e = std::shared_ptr<Enumerator<T> >(new Enumerators::Filter<T>(enumerator(), predicate));
-            return ENUMERABLE_PTR(T)(new GenericEnumerable<T>(e));
+            typedef std::pair<TKey, std::vector<T> > Group;
+            ENUMERABLE_PTR(T) source = this->shared_from_this();
+
+            return chain<Group>("group_by", [=]()
+            {
+                return std::make_shared<Enumerators::Deferred<Group> >([=]()
+                {
+                    std::map<TKey, std::vector<T> > groups;
+                    std::shared_ptr<Enumerator<T> > e = source->enumerator();
+                    bool consuming = is_consuming(*e);
+
+                    e->push([&](T& element)
+                    {
+                        groups[keySelector(element)].push_back(take(element, consuming));
+                        return true;
+                    });
+
+                    std::vector<Group> grouped;
+                    for (std::pair<const TKey, std::vector<T> >& group : groups)
+                    {
+                        grouped.push_back(Group(group.first, std::move(group.second)));
+                    }
+
+                    return std::make_shared<Enumerators::ContainerEnumerator<Group, std::vector<Group> > >(std::move(grouped));
+                });
+            });
         }
 
         ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Groups in at most about memoryBudget bytes, spilling hash partitions to temporary files beyond that. The
+        // elements and keys must have a Spill::Serializer.
         template <typename TKey>
-        std::map<TKey, T> to_map(std::function<TKey(const T&)> keySelector)
+        std::shared_ptr<IEnumerable<std::pair<TKey, std::vector<T> > > > group_by(std::function<TKey(const T&)> keySelector, size_t memoryBudget)
         {
-            return to_map<TKey, T>(keySelector, [](const T& t){ return t; });
+            typedef std::pair<TKey, std::vector<T> > Group;
+            ENUMERABLE_PTR(T) source = this->shared_from_this();
+
+            return chain<Group>("group_by", [=]()
+            {
+                std::shared_ptr<Enumerator<T> > e = source->enumerator();
+                return std::make_shared<Enumerators::ExternalGroup<T, TKey> >(e, keySelector, memoryBudget, is_consuming(*e));
+            });
         }
 
         ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
-        template <typename TKey, typename TResult>
-        std::map<TKey, TResult> to_map(std::function<TKey(const T&)> keySelector, std::function<TResult(const T&)> resultSelector)
+        // An aggregate over a source that keeps growing, such as Enumerable::from_append_only, that folds in only the
+        // elements appended since it was last evaluated. The query has to be resumable: the operators in between can
+        // only be where, select, distinct, except and consume. Others, such as concat, skip or order_by, would lose or
+        // repeat what's appended afterwards, so they're rejected.
+        template <typename TAccumulate>
+        IncrementalAggregate<T, TAccumulate, TAccumulate> incremental_aggregate(const TAccumulate& seed,
+            std::function<TAccumulate (const TAccumulate&, const T&)> accumulator)
         {
-            std::map<TKey, TResult> map;
+            return incremental_aggregate<TAccumulate, TAccumulate>(seed, accumulator, [](const TAccumulate& a){ return a; });
+        }
 
-            std::for_each(begin(), end(), [&](const T& t)
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        template <typename TAccumulate, typename TResult>
+        IncrementalAggregate<T, TAccumulate, TResult> incremental_aggregate(const TAccumulate& seed,
+            std::function<TAccumulate (const TAccumulate&, const T&)> accumulator,
+            std::function<TResult (const TAccumulate&)> resultSelector)
+        {
+            if (accumulator == nullptr)
             {
-                return map.insert(std::pair<TKey, TResult>(keySelector(t), resultSelector(t)));
-            });
+                throw std::runtime_error("An accumulator function is required");
+            }
 
-            return map;
+            return IncrementalAggregate<T, TAccumulate, TResult>(resumable_enumerator(), seed, accumulator, resultSelector);
         }
 
-    private:
-        template<typename TAccumulate>
-        double average(TAccumulate seed, std::function<TAccumulate(const T&)> selector)
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        template <typename TKey, typename TAccumulate>
+        IncrementalGroupedAggregate<T, TKey, TAccumulate> incremental_aggregate_by(std::function<TKey(const T&)> keySelector,
+            const TAccumulate& seed, std::function<TAccumulate (const TAccumulate&, const T&)> accumulator)
         {
-            if (selector == nullptr)
+            if (accumulator == nullptr)
             {
-                throw std::runtime_error("selector is required");
+                throw std::runtime_error("An accumulator function is required");
             }
 
-            auto accumulator = [&](const std::pair<TAccumulate, int>& acc, const T& t)
-            {
-                return std::pair<TAccumulate, int>(acc.first + selector(t), acc.second + 1);
-            };
+            return IncrementalGroupedAggregate<T, TKey, TAccumulate>(resumable_enumerator(), keySelector, seed, accumulator);
+        }
 
-            auto resultSelector = [](const std::pair<TAccumulate, int>& acc)
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Records the elements the first time they're enumerated and replays them from memory after that, so calling
+        // several terminal operators on an expensive query only runs it once. Recording is lazy and shared: first()
+        // computes a single element, and later enumerations, on any thread, pick up where the furthest one got to.
+        // The recording is never refreshed, and the elements must not be moved out of it, e.g. by consume().
+        ENUMERABLE_PTR(T) memoize()
+        {
+            ENUMERABLE_PTR(T) source = this->shared_from_this();
+            std::shared_ptr<Enumerators::Memo<T> > memo = std::make_shared<Enumerators::Memo<T> >([=]()
             {
-                return static_cast<double>(acc.first) / acc.second;
-            };
+                return source->enumerator();
+            });
 
-            return aggregate<std::pair<TAccumulate, int>, TAccumulate>(std::pair<TAccumulate, int>(seed, 0), accumulator, resultSelector);
+            return chain<T>("memoize", [=]()
+            {
+                return std::make_shared<Enumerators::MemoEnumerator<T> >(memo);
+            });
         }
 
-        template<typename TAccumulate>
-        TAccumulate fold(Enumerator<T>& enumerator, const TAccumulate& seed, std::function<TAccumulate (const TAccumulate&, const T&)> accumulator)
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        template <typename TKey>
+        ENUMERABLE_PTR(T) order_by(std::function<TKey(const T&)> keySelector)
         {
-            TAccumulate result = seed;
+            ENUMERABLE_PTR(T) source = this->shared_from_this();
 
-            while (enumerator.move_next())
+            return chain<T>("order_by", [=]()
             {
-                result = accumulator(result, enumerator.current_ref());
-            }
-
-            return result;
+                return std::make_shared<Enumerators::Deferred<T> >([=]()
+                {
+                    std::vector<std::pair<TKey, T> > keyed;
+                    std::shared_ptr<Enumerator<T> > e = source->enumerator();
+                    bool consuming = is_consuming(*e);
+
+                    e->push([&](T& element)
+                    {
+                        TKey key = keySelector(element);
+                        keyed.push_back(std::pair<TKey, T>(std::move(key), take(element, consuming)));
+                        return true;
+                    });
+
+                    std::stable_sort(keyed.begin(), keyed.end(), [](const std::pair<TKey, T>& x, const std::pair<TKey, T>& y)
+                    {
+                        return x.first < y.first;
+                    });
+
+                    std::vector<T> sorted;
+                    sorted.reserve(keyed.size());
+                    for (std::pair<TKey, T>& element : keyed)
+                    {
+                        sorted.push_back(std::move(element.second));
+                    }
+
+                    return std::make_shared<Enumerators::ContainerEnumerator<T, std::vector<T> > >(std::move(sorted));
+                });
+            });
         }
-    };
-
-    template <typename T>
-    class Iterator : public std::iterator<std::forward_iterator_tag, T>
-    {
-        friend class IEnumerable<T>;
 
-    public:
-        Iterator(const Iterator& other)
-            : enumerator_(other.enumerator_)
-            , isEnd_(other.isEnd_)
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Sorts in at most about memoryBudget bytes, spilling sorted runs to temporary files beyond that. The elements
+        // and keys must have a Spill::Serializer.
+        template <typename TKey>
+        ENUMERABLE_PTR(T) order_by(std::function<TKey(const T&)> keySelector, size_t memoryBudget)
         {
-        }
+            ENUMERABLE_PTR(T) source = this->shared_from_this();
 
-        Iterator& operator++()
-        {
-            if (!enumerator_.move_next())
+            return chain<T>("order_by", [=]()
             {
-                isEnd_ = true;
-            }
-            
-            return *this;
+                std::shared_ptr<Enumerator<T> > e = source->enumerator();
+                return std::make_shared<Enumerators::ExternalSort<T, TKey> >(e, keySelector, memoryBudget, is_consuming(*e));
+            });
         }
 
-        Iterator operator++(int)
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // The KLL sketch behind approx_quantiles, which can be merged with sketches of other sequences.
+        Sketches::KllSketch<T> quantile_sketch(size_t k = 200)
         {
-            Iterator tmp(*this);
-            operator++();
-            return tmp;
-        }
+            Sketches::KllSketch<T> sketch(k);
+            enumerator()->push([&](T& element)
+            {
+                sketch.add(element);
+                return true;
+            });
 
-        bool operator==(const Iterator& rhs) const
-        {
-            return (&enumerator_ == &rhs.enumerator_) && ((isEnd_ && rhs.isEnd_));
+            return sketch;
         }
 
-        bool operator!=(const Iterator& rhs) const
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // A uniform sample of count elements, or all of them if there are fewer, in no particular order. Each
+        // enumeration draws the same sample for the same seed, when it is first pulled from. Random access sources
+        // are read only at the picked positions.
+        ENUMERABLE_PTR(T) sample(size_t count, uint64_t seed = 0)
         {
-            return !(*this == rhs);
-        }
+            ENUMERABLE_PTR(T) source = this->shared_from_this();
 
-        T& operator*()
-        {
-            return enumerator_.current_ref();
+            return chain<T>("sample", [=]()
+            {
+                return std::make_shared<Enumerators::Deferred<T> >([=]()
+                {
+                    Enumerators::Reservoir<T> reservoir(count, seed);
+                    std::shared_ptr<Enumerator<T> > e = source->enumerator();
+                    bool consuming = is_consuming(*e);
+
+                    if (auto random = e->random_access())
+                    {
+                        size_t size = random->size();
+                        for (size_t i = reservoir.next(); i < size && random->seek(i); i = reservoir.next())
+                        {
+                            reservoir.add(take(e->current_ref(), consuming));
+                        }
+                    }
+                    else
+                    {
+                        size_t i = 0;
+                        e->push([&](T& element)
+                        {
+                            if (i++ == reservoir.next())
+                            {
+                                reservoir.add(take(element, consuming));
+                            }
+                            return true;
+                        });
+                    }
+
+                    return std::make_shared<Enumerators::ContainerEnumerator<T, std::vector<T> > >(std::move(reservoir.elements()));
+                });
+            });
         }
 
-    private:
-        explicit Iterator(Enumerator<T>& enumerator)
-            : enumerator_(enumerator)
-            , isEnd_(false)
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Keeps each element independently with the given probability, in order. Each enumeration keeps the same
+        // elements for the same seed.
+        ENUMERABLE_PTR(T) sample_fraction(double probability, uint64_t seed = 0)
         {
-        }
+            if (!(probability >= 0.0 && probability <= 1.0))
+            {
+                throw std::out_of_range("A probability must be between 0 and 1");
+            }
 
-        Iterator(Enumerator<T>& enumerator, bool isEnd)
-            : enumerator_(enumerator)
-            , isEnd_(isEnd)
-        {
-        }
+            ENUMERABLE_PTR(T) source = this->shared_from_this();
 
-        Enumerator<T>& enumerator_;
+            return chain<T>("sample_fraction", [=]()
+            {
+                std::shared_ptr<Enumerator<T> > e = source->enumerator();
+                return std::make_shared<Enumerators::BernoulliSample<T> >(e, e->random_access(), probability, seed);
+            });
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        template <typename U>
+        ENUMERABLE_PTR(U) select(std::function<U(const T&)> selector)
+        {
+            if (selector == nullptr)
+            {
+                throw std::runtime_error("A selector is required");
+            }
+
+            ENUMERABLE_PTR(T) source = this->shared_from_this();
+
+            if (fusable() == Fusable::Projection)
+            {
+                return fuse<U>("select", [=]()
+                {
+                    std::shared_ptr<Enumerator<T> > e = Enumerators::unwrap(source->enumerator());
+                    auto& projection = static_cast<Enumerators::Projection<T>&>(*e);
+                    return std::make_shared<Enumerators::Projection<U> >(projection.select(selector));
+                }, Fusable::Projection);
+            }
+
+            if (fusable() == Fusable::Filter)
+            {
+                return fuse<U>("select", [=]()
+                {
+                    std::shared_ptr<Enumerators::Filter<T> > filter =
+                        std::static_pointer_cast<Enumerators::Filter<T> >(Enumerators::unwrap(source->enumerator()));
+                    return std::make_shared<Enumerators::Map<T, U> >(filter, selector);
+                }, Fusable::Projection);
+            }
+
+            return chain<U>("select", [=]()
+            {
+                return std::make_shared<Enumerators::Map<T, U> >(source->enumerator(), selector);
+            }, nullptr, Fusable::Projection);
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        ENUMERABLE_PTR(T) skip(size_t count)
+        {
+            ENUMERABLE_PTR(T) source = this->shared_from_this();
+            return chain<T>("skip", [=]()
+            {
+                std::shared_ptr<Enumerator<T> > e = source->enumerator();
+                return std::make_shared<Enumerators::Skip<T> >(e, e->random_access(), count);
+            });
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // The count, sum, minimum, maximum and average of arithmetic elements, in a single pass.
+        Aggregators::Statistics<T> stats()
+        {
+            return stats(Aggregators::Identity());
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // The statistics of the values a selector picks out of each element. The selector is a template parameter
+        // so that it can be inlined into the loops; a lambda or function object works best.
+        template <typename TSelector>
+        Aggregators::Statistics<typename Aggregators::Selected<TSelector, T>::type> stats(TSelector selector)
+        {
+            auto results = aggregate_many(Aggregators::count(), Aggregators::sum(selector), Aggregators::min(selector),
+                Aggregators::max(selector), Aggregators::average(selector));
+
+            if (std::get<0>(results) == 0)
+            {
+                throw std::runtime_error("can't compute statistics of an empty collection");
+            }
+
+            Aggregators::Statistics<typename Aggregators::Selected<TSelector, T>::type> statistics =
+            {
+                std::get<0>(results), std::get<1>(results), *std::get<2>(results), *std::get<3>(results), std::get<4>(results)
+            };
+            return statistics;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        T sum()
+        {
+            return sum(std::is_arithmetic<T>());
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // The elements of each window of the given length of time, e.g. every minute, in order. timeSelector gives the
+        // time of an element, which can be a number or a std::chrono::time_point; windows are counted from time zero,
+        // and elements are expected in time order. Windows with no elements are left out.
+        template <typename TTime, typename TLength>
+        ENUMERABLE_PTR(std::vector<T>) tumbling_window(std::function<TTime(const T&)> timeSelector, TLength length)
+        {
+            static_assert(std::is_copy_constructible<T>::value, "Windows copy their elements, which must be copyable");
+            if (!(TLength() < length))
+            {
+                throw std::runtime_error("A window length greater than zero is required");
+            }
+
+            ENUMERABLE_PTR(T) source = this->shared_from_this();
+            std::function<int64_t(const T&)> windowOf = [=](const T& t)
+            {
+                return Enumerators::window_index(timeSelector(t), length);
+            };
+
+            return chain<std::vector<T> >("tumbling_window", [=]()
+            {
+                return std::make_shared<Enumerators::TumblingWindow<T> >(source->enumerator(), windowOf);
+            });
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        ENUMERABLE_PTR(T) where(std::function<bool(const T&)> predicate)
+        {
+            if (predicate == nullptr)
+            {
+                throw std::runtime_error("A predicate is required");
+            }
+
+            ENUMERABLE_PTR(T) source = this->shared_from_this();
+
+            if (fusable() == Fusable::Filter)
+            {
+                return fuse<T>("where", [=]()
+                {
+                    std::shared_ptr<Enumerator<T> > e = Enumerators::unwrap(source->enumerator());
+                    static_cast<Enumerators::Filter<T>&>(*e).where(predicate);
+                    return e;
+                }, Fusable::Filter);
+            }
+
+            return chain<T>("where", [=]()
+            {
+                return std::make_shared<Enumerators::Filter<T> >(source->enumerator(), predicate);
+            }, nullptr, Fusable::Filter);
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // The elements of each window of size consecutive elements, starting a new window every step elements. Only
+        // full windows are produced. Copies the window out each time; the window_ aggregates below don't.
+        ENUMERABLE_PTR(std::vector<T>) window(size_t size, size_t step = 1)
+        {
+            static_assert(std::is_copy_constructible<T>::value, "Overlapping windows copy their elements, which must be copyable");
+            check_window(size, step);
+
+            ENUMERABLE_PTR(T) source = this->shared_from_this();
+            return chain<std::vector<T> >("window", [=]()
+            {
+                return std::make_shared<Enumerators::SlidingWindow<T> >(source->enumerator(), size, step);
+            });
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Aggregates each window, as for window(size, step), with an accumulator that can be undone: remove takes an
+        // element back out of the accumulated value when it leaves the window, so the cost per element doesn't grow
+        // with the size of the window.
+        template <typename TAccumulate>
+        ENUMERABLE_PTR(TAccumulate) window_aggregate(size_t size, size_t step, const TAccumulate& seed,
+            std::function<TAccumulate (const TAccumulate&, const T&)> add,
+            std::function<TAccumulate (const TAccumulate&, const T&)> remove)
+        {
+            static_assert(std::is_copy_constructible<T>::value, "Sliding aggregates keep copies of the elements in the window, which must be copyable");
+            check_window(size, step);
+
+            if (add == nullptr || remove == nullptr)
+            {
+                throw std::runtime_error("An accumulator function is required");
+            }
+
+            ENUMERABLE_PTR(T) source = this->shared_from_this();
+            return chain<TAccumulate>("window_aggregate", [=]()
+            {
+                return std::make_shared<Enumerators::SlidingAggregate<T, TAccumulate> >(source->enumerator(), size, step, seed, add, remove);
+            });
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        ENUMERABLE_PTR(double) window_average(size_t size, size_t step = 1)
+        {
+            return window_average(size, step, std::is_integral<T>());
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        ENUMERABLE_PTR(T) window_max(size_t size, size_t step = 1)
+        {
+            return window_extreme("window_max", size, step, [](const T& x, const T& y){ return y < x; });
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        ENUMERABLE_PTR(T) window_min(size_t size, size_t step = 1)
+        {
+            return window_extreme("window_min", size, step, [](const T& x, const T& y){ return x < y; });
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        ENUMERABLE_PTR(T) window_sum(size_t size, size_t step = 1)
+        {
+            return window_sum(size, step, std::is_floating_point<T>());
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        std::deque<T> to_deque()
+        {
+            std::deque<T> deque;
+            materialize(*enumerator(), deque);
+            return deque;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Like to_map, keeping the first element for each key, but in a FlatMap sized up front when the source knows
+        // how many elements it has.
+        template <typename TKey>
+        FlatMap<TKey, T> to_flat_map(std::function<TKey(const T&)> keySelector)
+        {
+            std::shared_ptr<Enumerator<T> > e = enumerator();
+            bool consuming = is_consuming(*e);
+            FlatMap<TKey, T> map(size_hint(*e));
+
+            e->push([&](T& element)
+            {
+                TKey key = keySelector(element);
+                if (!map.contains(key))
+                {
+                    map.insert(std::move(key), take(element, consuming));
+                }
+                return true;
+            });
+
+            return map;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        template <typename TKey, typename TResult>
+        FlatMap<TKey, TResult> to_flat_map(std::function<TKey(const T&)> keySelector, std::function<TResult(const T&)> resultSelector)
+        {
+            std::shared_ptr<Enumerator<T> > e = enumerator();
+            FlatMap<TKey, TResult> map(size_hint(*e));
+
+            e->push([&](T& t)
+            {
+                map.insert(keySelector(t), resultSelector(t));
+                return true;
+            });
+
+            return map;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        std::list<T> to_list()
+        {
+            std::list<T> list;
+            materialize(*enumerator(), list);
+            return list;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Every element grouped by key, unlike to_map, which keeps one element per key.
+        template <typename TKey>
+        Lookup<TKey, T> to_lookup(std::function<TKey(const T&)> keySelector)
+        {
+            std::shared_ptr<Enumerator<T> > e = enumerator();
+            bool consuming = is_consuming(*e);
+
+            FlatMap<TKey, size_t> groups;
+            std::vector<size_t> groupOf;
+            std::vector<T> elements;
+            groupOf.reserve(size_hint(*e));
+            elements.reserve(size_hint(*e));
+
+            e->push([&](T& element)
+            {
+                TKey key = keySelector(element);
+                const size_t* group = groups.find(key);
+                if (group == nullptr)
+                {
+                    groupOf.push_back(groups.size());
+                    groups.insert(std::move(key), groups.size());
+                }
+                else
+                {
+                    groupOf.push_back(*group);
+                }
+
+                elements.push_back(take(element, consuming));
+                return true;
+            });
+
+            return Lookup<TKey, T>(std::move(groups), groupOf, std::move(elements));
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        template <typename TKey>
+        std::map<TKey, T> to_map(std::function<TKey(const T&)> keySelector)
+        {
+            std::map<TKey, T> map;
+
+            std::shared_ptr<Enumerator<T> > e = enumerator();
+            bool consuming = is_consuming(*e);
+
+            e->push([&](T& element)
+            {
+                TKey key = keySelector(element);
+                map.insert(std::pair<TKey, T>(std::move(key), take(element, consuming)));
+                return true;
+            });
+
+            return map;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        template <typename TKey, typename TResult>
+        std::map<TKey, TResult> to_map(std::function<TKey(const T&)> keySelector, std::function<TResult(const T&)> resultSelector)
+        {
+            std::map<TKey, TResult> map;
+
+            enumerator()->push([&](T& t)
+            {
+                map.insert(std::pair<TKey, TResult>(keySelector(t), resultSelector(t)));
+                return true;
+            });
+
+            return map;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Like to_map, keeping the first element for each key, but reserving buckets up front when the source knows
+        // how many elements it has.
+        template <typename TKey>
+        std::unordered_map<TKey, T> to_unordered_map(std::function<TKey(const T&)> keySelector)
+        {
+            std::shared_ptr<Enumerator<T> > e = enumerator();
+            bool consuming = is_consuming(*e);
+            std::unordered_map<TKey, T> map;
+            map.reserve(size_hint(*e));
+
+            e->push([&](T& element)
+            {
+                TKey key = keySelector(element);
+                if (map.find(key) == map.end())
+                {
+                    map.insert(std::pair<TKey, T>(std::move(key), take(element, consuming)));
+                }
+                return true;
+            });
+
+            return map;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        template <typename TKey, typename TResult>
+        std::unordered_map<TKey, TResult> to_unordered_map(std::function<TKey(const T&)> keySelector, std::function<TResult(const T&)> resultSelector)
+        {
+            std::shared_ptr<Enumerator<T> > e = enumerator();
+            std::unordered_map<TKey, TResult> map;
+            map.reserve(size_hint(*e));
+
+            e->push([&](T& t)
+            {
+                map.insert(std::pair<TKey, TResult>(keySelector(t), resultSelector(t)));
+                return true;
+            });
+
+            return map;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        std::vector<T> to_vector()
+        {
+            std::shared_ptr<Enumerator<T> > e = enumerator();
+            std::vector<T> vector;
+
+            if (auto sized = e->random_access())
+            {
+                vector.reserve(sized->size());
+            }
+
+            materialize(*e, vector);
+            return vector;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        Optional<T> try_element_at(const size_t index)
+        {
+            std::shared_ptr<Enumerator<T> > e = enumerator();
+            T* element = find_at(*e, index);
+            return element != nullptr ? Optional<T>(take(*element, is_consuming(*e))) : Optional<T>();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        Optional<T> try_first()
+        {
+            return try_element_at(0);
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        Optional<T> try_first(std::function<bool(const T&)> predicate)
+        {
+            std::shared_ptr<Enumerator<T> > e = enumerator();
+            T* element = find_first(*e, predicate);
+            return element != nullptr ? Optional<T>(take(*element, is_consuming(*e))) : Optional<T>();
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        Optional<T> try_last()
+        {
+            std::shared_ptr<Enumerator<T> > e = enumerator();
+            bool consuming = is_consuming(*e);
+
+            if (auto random = e->random_access())
+            {
+                size_t size = random->size();
+                return size > 0 && random->seek(size - 1) ? Optional<T>(take(e->current_ref(), consuming)) : Optional<T>();
+            }
+
+            Optional<T> last;
+            while (e->move_next())
+            {
+                last = Optional<T>(take(e->current_ref(), consuming));
+            }
+
+            return last;
+        }
+
+        ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Empty unless the collection holds exactly one element.
+        Optional<T> try_single()
+        {
+            std::shared_ptr<Enumerator<T> > e = enumerator();
+            bool consuming = is_consuming(*e);
+
+            if (auto random = e->random_access())
+            {
+                return random->size() == 1 && random->seek(0) ? Optional<T>(take(e->current_ref(), consuming)) : Optional<T>();
+            }
+
+            if (!e->move_next())
+            {
+                return Optional<T>();
+            }
+
+            Optional<T> single(take(e->current_ref(), consuming));
+            return e->move_next() ? Optional<T>() : std::move(single);
+        }
+
+    protected:
+        // What the next operator can fuse with; enumerables that don't say can't be fused with.
+        virtual Fusable fusable() const
+        {
+            return Fusable::None;
+        }
+
+        // The elements contains has to compare value with, for enumerables that can narrow them down without a scan,
+        // such as IndexedEnumerable and DictionaryColumn; null for all of them.
+        virtual ENUMERABLE_PTR(T) candidates_equal_to(const T&) const
+        {
+            return nullptr;
+        }
+
+        // The distinct elements in order of first appearance, for enumerables that can find them without comparing
+        // the elements, such as DictionaryColumn; null for the rest, which distinct filters with a map.
+        virtual ENUMERABLE_PTR(T) distinct_values() const
+        {
+            return nullptr;
+        }
+
+    private:
+        template <typename U>
+        ENUMERABLE_PTR(U) chain(const char* name, EnumeratorFactory<U> factory, IEnumerable<T>* other = nullptr,
+                                Fusable fusable = Fusable::None)
+        {
+#ifdef LINQ_PLUSPLUS_INSTRUMENTATION
+            std::vector<Diagnostics::OperatorStatistics::Ptr> inputs(1, statistics());
+            if (other != nullptr)
+            {
+                inputs.push_back(other->statistics());
+            }
+
+            Diagnostics::OperatorStatistics::Ptr node(new Diagnostics::OperatorStatistics(name, inputs));
+            return ENUMERABLE_PTR(U)(new GenericEnumerable<U>(factory, node, fusable));
+#else
+            (void)name; (void)other;
+            return ENUMERABLE_PTR(U)(new GenericEnumerable<U>(factory, fusable));
+#endif
+        }
+
+        // For an operator that has been fused into this one: the result takes this operator's place in the tree. The
+        // factory gets at this operator's enumerator through Enumerators::unwrap, so it isn't counted twice.
+        template <typename U>
+        ENUMERABLE_PTR(U) fuse(const char* name, EnumeratorFactory<U> factory, Fusable fusable)
+        {
+#ifdef LINQ_PLUSPLUS_INSTRUMENTATION
+            Diagnostics::OperatorStatistics::Ptr upstream = statistics();
+            Diagnostics::OperatorStatistics::Ptr node(
+                new Diagnostics::OperatorStatistics(upstream->name() + "+" + name, upstream->inputs()));
+            return ENUMERABLE_PTR(U)(new GenericEnumerable<U>(factory, node, fusable));
+#else
+            (void)name;
+            return ENUMERABLE_PTR(U)(new GenericEnumerable<U>(factory, fusable));
+#endif
+        }
+
+        static void check_window(size_t size, size_t step)
+        {
+            if (size == 0 || step == 0)
+            {
+                throw std::runtime_error("A window size and step greater than zero are required");
+            }
+        }
+
+        ENUMERABLE_PTR(T) window_extreme(const char* name, size_t size, size_t step, std::function<bool(const T&, const T&)> before)
+        {
+            static_assert(std::is_copy_constructible<T>::value, "Sliding extremes keep copies of the elements in the window, which must be copyable");
+            check_window(size, step);
+
+            ENUMERABLE_PTR(T) source = this->shared_from_this();
+            return chain<T>(name, [=]()
+            {
+                return std::make_shared<Enumerators::SlidingExtreme<T> >(source->enumerator(), size, step, before);
+            });
+        }
+
+        // Positions the enumerator on the element at index and returns it, or returns null if there is no such element.
+        static T* find_at(Enumerator<T>& e, size_t index)
+        {
+            if (auto random = e.random_access())
+            {
+                return random->seek(index) ? &e.current_ref() : nullptr;
+            }
+
+            for (size_t i = 0; e.move_next(); ++i)
+            {
+                if (i == index)
+                {
+                    return &e.current_ref();
+                }
+            }
+
+            return nullptr;
+        }
+
+        static T* find_first(Enumerator<T>& e, const std::function<bool(const T&)>& predicate)
+        {
+            if (predicate == nullptr)
+            {
+                throw std::runtime_error("Argument is null: A predicate is required");
+            }
+
+            while (e.move_next())
+            {
+                T& element = e.current_ref();
+
+                if (predicate(element))
+                {
+                    return &element;
+                }
+            }
+
+            return nullptr;
+        }
+
+        // How many elements the enumerator will produce, if it knows without enumerating them, or else 0.
+        static size_t size_hint(Enumerator<T>& e)
+        {
+            Enumerators::RandomAccess* random = e.random_access();
+            return random != nullptr ? random->size() : 0;
+        }
+
+        std::shared_ptr<Enumerator<T> > resumable_enumerator() const
+        {
+            std::shared_ptr<Enumerator<T> > e = enumerator();
+
+            if (!e->resumable())
+            {
+                throw std::runtime_error("Invalid operation: incremental aggregates require a resumable query over a growing source");
+            }
+
+            return e;
+        }
+
+        // Integral elements are totalled exactly, in 64 bits, and anything else with a compensated sum, so that adding
+        // elements as they enter the window and taking them out as they leave doesn't let rounding errors pile up.
+        ENUMERABLE_PTR(double) window_average(size_t size, size_t step, std::true_type)
+        {
+            typedef typename Aggregators::Total<T>::type Total;
+            double count = static_cast<double>(size);
+
+            return window_aggregate<Total>(size, step, Total(),
+                [](const Total& sum, const T& t){ return static_cast<Total>(sum + t); },
+                [](const Total& sum, const T& t){ return static_cast<Total>(sum - t); })
+                ->template select<double>([=](const Total& sum){ return static_cast<double>(sum) / count; });
+        }
+
+        ENUMERABLE_PTR(double) window_average(size_t size, size_t step, std::false_type)
+        {
+            typedef Aggregators::CompensatedSum Sum;
+            double count = static_cast<double>(size);
+
+            return window_aggregate<Sum>(size, step, Sum(),
+                [](const Sum& sum, const T& t){ return sum.add(static_cast<double>(t)); },
+                [](const Sum& sum, const T& t){ return sum.add(-static_cast<double>(t)); })
+                ->template select<double>([=](const Sum& sum){ return sum.value() / count; });
+        }
+
+        // Floating-point elements are totalled with a compensated sum, as for window_average.
+        ENUMERABLE_PTR(T) window_sum(size_t size, size_t step, std::true_type)
+        {
+            typedef Aggregators::CompensatedSum Sum;
+
+            return window_aggregate<Sum>(size, step, Sum(),
+                [](const Sum& sum, const T& t){ return sum.add(static_cast<double>(t)); },
+                [](const Sum& sum, const T& t){ return sum.add(-static_cast<double>(t)); })
+                ->template select<T>([](const Sum& sum){ return static_cast<T>(sum.value()); });
+        }
+
+        ENUMERABLE_PTR(T) window_sum(size_t size, size_t step, std::false_type)
+        {
+            return window_aggregate<T>(size, step, T(),
+                [](const T& sum, const T& t){ return sum + t; },
+                [](const T& sum, const T& t){ return sum - t; });
+        }
+
+        // Whether the query is marked with consume() and its elements can be moved out of where they are held.
+        static bool is_consuming(Enumerator<T>& e)
+        {
+            return dynamic_cast<Enumerators::Consume<T>*>(&Enumerators::unwrap(e)) != nullptr && e.movable();
+        }
+
+        static T take(T& element, bool consuming)
+        {
+            if (consuming)
+            {
+                return std::move(element);
+            }
+
+            return Enumerators::copy_value(element);
+        }
+
+        template <typename Container>
+        static void materialize(Enumerator<T>& e, Container& container)
+        {
+            bool consuming = is_consuming(e);
+
+            e.push([&](T& element)
+            {
+                container.push_back(take(element, consuming));
+                return true;
+            });
+        }
+
+        template<typename TAccumulate>
+        double average(TAccumulate seed, std::function<TAccumulate(const T&)> selector)
+        {
+            if (selector == nullptr)
+            {
+                throw std::runtime_error("selector is required");
+            }
+
+            auto accumulator = [&](const std::pair<TAccumulate, int>& acc, const T& t)
+            {
+                return std::pair<TAccumulate, int>(acc.first + selector(t), acc.second + 1);
+            };
+
+            auto resultSelector = [](const std::pair<TAccumulate, int>& acc)
+            {
+                return static_cast<double>(acc.first) / acc.second;
+            };
+
+            return aggregate<std::pair<TAccumulate, int>, TAccumulate>(std::pair<TAccumulate, int>(seed, 0), accumulator, resultSelector);
+        }
+
+        T sum(std::true_type)
+        {
+            std::shared_ptr<Enumerator<T> > e = enumerator();
+
+            if (auto sequence = dynamic_cast<Enumerators::ArithmeticSequence<T>*>(&Enumerators::unwrap(*e)))
+            {
+                return sequence->sum();
+            }
+
+            return sum(std::false_type());
+        }
+
+        T sum(std::false_type)
+        {
+            return aggregate<T>(T(), [](const T& acc, const T& t){ return acc + t; });
+        }
+
+        template<typename TAccumulate>
+        TAccumulate fold(Enumerator<T>& enumerator, const TAccumulate& seed, std::function<TAccumulate (const TAccumulate&, const T&)> accumulator)
+        {
+            TAccumulate result = seed;
+
+            enumerator.push([&](T& t)
+            {
+                result = accumulator(result, t);
+                return true;
+            });
+
+            return result;
+        }
+    };
+
+    // A single pass iterator over a fresh enumerator: copies share that enumerator, so advancing one advances them
+    // all. Equal to the end iterator once the enumeration is exhausted, which makes a begin()/end() pair a common
+    // range for the standard algorithms and for std::ranges.
+    template <typename T>
+    class Iterator
+    {
+        friend class IEnumerable<T>;
+
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef std::input_iterator_tag iterator_concept;
+        typedef T value_type;
+        typedef ptrdiff_t difference_type;
+        typedef T* pointer;
+        typedef T& reference;
+
+        // The end iterator.
+        Iterator()
+            : enumerator_()
+            , isEnd_(true)
+        {
+        }
+
+        Iterator(const Iterator& other)
+            : enumerator_(other.enumerator_)
+            , isEnd_(other.isEnd_)
+        {
+        }
+
+        Iterator& operator=(const Iterator& rhs)
+        {
+            enumerator_ = rhs.enumerator_;
+            isEnd_ = rhs.isEnd_;
+            return *this;
+        }
+
+        Iterator& operator++()
+        {
+            if (!enumerator_->move_next())
+            {
+                isEnd_ = true;
+            }
+            
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator tmp(*this);
+            operator++();
+            return tmp;
+        }
+
+        bool operator==(const Iterator& rhs) const
+        {
+            return isEnd_ == rhs.isEnd_ && (isEnd_ || enumerator_ == rhs.enumerator_);
+        }
+
+        bool operator!=(const Iterator& rhs) const
+        {
+            return !(*this == rhs);
+        }
+
+        T& operator*() const
+        {
+            return enumerator_->current_ref();
+        }
+
+        T* operator->() const
+        {
+            return &enumerator_->current_ref();
+        }
+
+    private:
+        explicit Iterator(std::shared_ptr<Enumerator<T> > enumerator)
+            : enumerator_(enumerator)
+            , isEnd_(!enumerator_->move_next())
+        {
+        }
+
+        std::shared_ptr<Enumerator<T> > enumerator_;
         bool isEnd_;
     };
 
+    // A random access iterator over an enumerable whose enumerators support random access. Each copy positions its
+    // own enumerator, created when it is first dereferenced, so copies can be handed to different threads as the
+    // parallel algorithms do. Elements are returned by value, as most random access queries compute them (ranges,
+    // sequences, selects), so they can't be move-only. Strictly, a forward or random access iterator's reference has
+    // to be a real reference; like other proxy iterators this one claims the random access category regardless,
+    // since that is what the parallel algorithms check before splitting the work. Code that keeps a reference to an
+    // element past the next increment can't use it.
+    template <typename T>
+    class RandomAccessIterator
+    {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef std::random_access_iterator_tag iterator_concept;
+        typedef T value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const T* pointer;
+        typedef T reference;
+
+        RandomAccessIterator()
+            : source_()
+            , index_(0)
+            , enumerator_()
+            , random_(nullptr)
+            , position_(0)
+        {
+        }
+
+        RandomAccessIterator(std::shared_ptr<const IEnumerable<T> > source, size_t index)
+            : source_(source)
+            , index_(index)
+            , enumerator_()
+            , random_(nullptr)
+            , position_(0)
+        {
+        }
+
+        RandomAccessIterator(const RandomAccessIterator& other)
+            : source_(other.source_)
+            , index_(other.index_)
+            , enumerator_()
+            , random_(nullptr)
+            , position_(0)
+        {
+        }
+
+        RandomAccessIterator& operator=(const RandomAccessIterator& rhs)
+        {
+            if (source_ != rhs.source_)
+            {
+                enumerator_.reset();
+                random_ = nullptr;
+            }
+
+            source_ = rhs.source_;
+            index_ = rhs.index_;
+            return *this;
+        }
+
+        reference operator*() const
+        {
+            return Enumerators::copy_value(at(index_));
+        }
+
+        // Only valid until the iterator is moved or destroyed.
+        pointer operator->() const
+        {
+            return &at(index_);
+        }
+
+        reference operator[](difference_type n) const
+        {
+            return Enumerators::copy_value(at(index_ + n));
+        }
+
+        RandomAccessIterator& operator++()
+        {
+            ++index_;
+            return *this;
+        }
+
+        RandomAccessIterator operator++(int)
+        {
+            RandomAccessIterator tmp(*this);
+            ++index_;
+            return tmp;
+        }
+
+        RandomAccessIterator& operator--()
+        {
+            --index_;
+            return *this;
+        }
+
+        RandomAccessIterator operator--(int)
+        {
+            RandomAccessIterator tmp(*this);
+            --index_;
+            return tmp;
+        }
+
+        RandomAccessIterator& operator+=(difference_type n)
+        {
+            index_ += n;
+            return *this;
+        }
+
+        RandomAccessIterator& operator-=(difference_type n)
+        {
+            index_ -= n;
+            return *this;
+        }
+
+        RandomAccessIterator operator+(difference_type n) const
+        {
+            RandomAccessIterator tmp(*this);
+            return tmp += n;
+        }
+
+        RandomAccessIterator operator-(difference_type n) const
+        {
+            RandomAccessIterator tmp(*this);
+            return tmp -= n;
+        }
+
+        friend RandomAccessIterator operator+(difference_type n, const RandomAccessIterator& it)
+        {
+            return it + n;
+        }
+
+        difference_type operator-(const RandomAccessIterator& rhs) const
+        {
+            return static_cast<difference_type>(index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        bool operator==(const RandomAccessIterator& rhs) const
+        {
+            return index_ == rhs.index_;
+        }
+
+        bool operator!=(const RandomAccessIterator& rhs) const
+        {
+            return index_ != rhs.index_;
+        }
+
+        bool operator<(const RandomAccessIterator& rhs) const
+        {
+            return index_ < rhs.index_;
+        }
+
+        bool operator>(const RandomAccessIterator& rhs) const
+        {
+            return index_ > rhs.index_;
+        }
+
+        bool operator<=(const RandomAccessIterator& rhs) const
+        {
+            return index_ <= rhs.index_;
+        }
+
+        bool operator>=(const RandomAccessIterator& rhs) const
+        {
+            return index_ >= rhs.index_;
+        }
+
+    private:
+        const T& at(size_t index) const
+        {
+            bool found;
+
+            if (enumerator_ == nullptr)
+            {
+                enumerator_ = source_->enumerator();
+                random_ = enumerator_->random_access();
+                found = random_->seek(index);
+            }
+            else if (index == position_)
+            {
+                found = true;
+            }
+            else
+            {
+                // Consecutive elements are reached by move_next, which is cheaper than a seek for most sources.
+                found = index == position_ + 1 ? enumerator_->move_next() : random_->seek(index);
+            }
+
+            if (!found)
+            {
+                enumerator_.reset();
+                throw std::out_of_range("Iterator is out of range");
+            }
+
+            position_ = index;
+            return enumerator_->current_ref();
+        }
+
+        std::shared_ptr<const IEnumerable<T> > source_;
+        size_t index_;
+        mutable std::shared_ptr<Enumerator<T> > enumerator_;
+        mutable Enumerators::RandomAccess* random_;
+        mutable size_t position_;
+    };
+
+    // The elements of a random access enumerable as a sized range, see IEnumerable::indexed.
+    template <typename T>
+    class IndexedRange
+    {
+    public:
+        typedef RandomAccessIterator<T> iterator;
+        typedef RandomAccessIterator<T> const_iterator;
+
+        IndexedRange(std::shared_ptr<const IEnumerable<T> > source, size_t size)
+            : source_(source)
+            , size_(size)
+        {
+        }
+
+        IndexedRange(const IndexedRange& other)
+            : source_(other.source_)
+            , size_(other.size_)
+        {
+        }
+
+        IndexedRange& operator=(const IndexedRange& rhs)
+        {
+            source_ = rhs.source_;
+            size_ = rhs.size_;
+            return *this;
+        }
+
+        iterator begin() const
+        {
+            return iterator(source_, 0);
+        }
+
+        iterator end() const
+        {
+            return iterator(source_, size_);
+        }
+
+        size_t size() const
+        {
+            return size_;
+        }
+
+        bool empty() const
+        {
+            return size_ == 0;
+        }
+
+        T operator[](size_t index) const
+        {
+            return begin()[index];
+        }
+
+    private:
+        std::shared_ptr<const IEnumerable<T> > source_;
+        size_t size_;
+    };
+
     template <typename T>
     class GenericEnumerable: public IEnumerable<T>
     {
     public:
-        explicit GenericEnumerable(std::shared_ptr<Enumerator<T> > enumerator)
-            : enumerator_(enumerator)
+#ifdef LINQ_PLUSPLUS_INSTRUMENTATION
+        explicit GenericEnumerable(EnumeratorFactory<T> factory)
+            : GenericEnumerable(factory, Diagnostics::OperatorStatistics::Ptr(
+                new Diagnostics::OperatorStatistics("enumerable", std::vector<Diagnostics::OperatorStatistics::Ptr>())))
+        {
+        }
+
+        GenericEnumerable(EnumeratorFactory<T> factory, Diagnostics::OperatorStatistics::Ptr statistics,
+                          Fusable fusable = Fusable::None)
+            : factory_(factory)
+            , statistics_(statistics)
+            , fusable_(fusable)
         {
-            
         }
 
         GenericEnumerable(const GenericEnumerable& other)
-            : enumerator_(other.enumerator_)
+            : factory_(other.factory_)
+            , statistics_(other.statistics_)
+            , fusable_(other.fusable_)
         {
         }
+#else
+        explicit GenericEnumerable(EnumeratorFactory<T> factory, Fusable fusable = Fusable::None)
+            : factory_(factory)
+            , fusable_(fusable)
+        {
+        }
+
+        GenericEnumerable(const GenericEnumerable& other)
+            : factory_(other.factory_)
+            , fusable_(other.fusable_)
+        {
+        }
+#endif
 
         virtual ~GenericEnumerable(){}
 
         GenericEnumerable& operator=(const GenericEnumerable& rhs)
         {
-            enumerator_ = rhs.enumerator_;
+            factory_ = rhs.factory_;
+            fusable_ = rhs.fusable_;
+#ifdef LINQ_PLUSPLUS_INSTRUMENTATION
+            statistics_ = rhs.statistics_;
+#endif
             return *this;
         }
 
-        virtual Enumerator<T>& enumerator(bool initialize = true) override
+        virtual std::shared_ptr<Enumerator<T> > enumerator() const override
+        {
+#ifdef LINQ_PLUSPLUS_INSTRUMENTATION
+            return std::make_shared<Enumerators::Instrumented<T> >(factory_(), statistics_);
+#else
+            return factory_();
+#endif
+        }
+
+#ifdef LINQ_PLUSPLUS_INSTRUMENTATION
+        virtual Diagnostics::OperatorStatistics::Ptr statistics() const override
+        {
+            return statistics_;
+        }
+#endif
+
+    protected:
+        virtual Fusable fusable() const override
         {
-            if (initialize) enumerator_->reset();
-            return *enumerator_;
+            return fusable_;
         }
 
     private:
-        std::shared_ptr<Enumerator<T> > enumerator_;
+        EnumeratorFactory<T> factory_;
+#ifdef LINQ_PLUSPLUS_INSTRUMENTATION
+        Diagnostics::OperatorStatistics::Ptr statistics_;
+#endif
+        Fusable fusable_;
     };
+
+    // For enumerators that read directly from a source rather than from another enumerable.
+    template <typename T>
+    ENUMERABLE_PTR(T) make_source(const char* name, EnumeratorFactory<T> factory)
+    {
+#ifdef LINQ_PLUSPLUS_INSTRUMENTATION
+        Diagnostics::OperatorStatistics::Ptr statistics(
+            new Diagnostics::OperatorStatistics(name, std::vector<Diagnostics::OperatorStatistics::Ptr>()));
+        return ENUMERABLE_PTR(T)(new GenericEnumerable<T>(factory, statistics));
+#else
+        (void)name;
+        return ENUMERABLE_PTR(T)(new GenericEnumerable<T>(factory));
+#endif
+    }
 }
 
+#include "DictionaryColumn.h"
+#include "IndexedEnumerable.h"
+
 #endif
@@ -0,0 +1,75 @@
+#ifndef LINQ_PLUSPLUS_INCREMENTAL_AGGREGATE_H
+#define LINQ_PLUSPLUS_INCREMENTAL_AGGREGATE_H
+
+#include "Enumerators/Enumerator.h"
+#include <functional>
+#include <memory>
+#include <stddef.h>
+
+namespace LinqPlusPlus
+{
+    // An aggregate kept up to date over a growing source, made by IEnumerable::incremental_aggregate. It holds on to
+    // an enumerator of the query along with the accumulated value, and each call to value() carries on from where
+    // the last one stopped, folding in only the elements appended since.
+    template <typename T, typename TAccumulate, typename TResult>
+    class IncrementalAggregate
+    {
+    public:
+        IncrementalAggregate(std::shared_ptr<Enumerator<T> > enumerator, const TAccumulate& seed,
+                             std::function<TAccumulate (const TAccumulate&, const T&)> accumulator,
+                             std::function<TResult (const TAccumulate&)> resultSelector)
+            : enumerator_(enumerator)
+            , seed_(seed)
+            , accumulator_(accumulator)
+            , resultSelector_(resultSelector)
+            , accumulated_(seed)
+            , watermark_(0)
+        {
+        }
+
+        IncrementalAggregate(IncrementalAggregate&& other) = default;
+        IncrementalAggregate& operator=(IncrementalAggregate&& rhs) = default;
+
+        // Copies would share the enumerator, and so each miss the elements the other folded in.
+        IncrementalAggregate(const IncrementalAggregate&) = delete;
+        IncrementalAggregate& operator=(const IncrementalAggregate&) = delete;
+
+        // Folds in the elements appended since the last call and returns the result over all of them so far.
+        TResult value()
+        {
+            enumerator_->push([this](T& element)
+            {
+                accumulated_ = accumulator_(accumulated_, element);
+                ++watermark_;
+                return true;
+            });
+
+            return resultSelector_(accumulated_);
+        }
+
+        // How many elements of the query have been folded in.
+        size_t watermark() const
+        {
+            return watermark_;
+        }
+
+        // Starts again from the seed, for when the source has changed other than by appending. The next value()
+        // rescans everything.
+        void reset()
+        {
+            enumerator_->reset();
+            accumulated_ = seed_;
+            watermark_ = 0;
+        }
+
+    private:
+        std::shared_ptr<Enumerator<T> > enumerator_;
+        TAccumulate seed_;
+        std::function<TAccumulate (const TAccumulate&, const T&)> accumulator_;
+        std::function<TResult (const TAccumulate&)> resultSelector_;
+        TAccumulate accumulated_;
+        size_t watermark_;
+    };
+}
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef LINQ_PLUSPLUS_INCREMENTAL_GROUPED_AGGREGATE_H
+#define LINQ_PLUSPLUS_INCREMENTAL_GROUPED_AGGREGATE_H
+
+#include "Enumerators/Enumerator.h"
+#include <functional>
+#include <map>
+#include <memory>
+#include <stddef.h>
+#include <utility>
+
+namespace LinqPlusPlus
+{
+    // As IncrementalAggregate, with an accumulated value per key, made by IEnumerable::incremental_aggregate_by.
+    // Keys seen for the first time start from the seed.
+    template <typename T, typename TKey, typename TAccumulate>
+    class IncrementalGroupedAggregate
+    {
+    public:
+        IncrementalGroupedAggregate(std::shared_ptr<Enumerator<T> > enumerator, std::function<TKey(const T&)> keySelector,
+                                    const TAccumulate& seed, std::function<TAccumulate (const TAccumulate&, const T&)> accumulator)
+            : enumerator_(enumerator)
+            , keySelector_(keySelector)
+            , seed_(seed)
+            , accumulator_(accumulator)
+            , watermark_(0)
+        {
+        }
+
+        IncrementalGroupedAggregate(IncrementalGroupedAggregate&& other) = default;
+        IncrementalGroupedAggregate& operator=(IncrementalGroupedAggregate&& rhs) = default;
+
+        IncrementalGroupedAggregate(const IncrementalGroupedAggregate&) = delete;
+        IncrementalGroupedAggregate& operator=(const IncrementalGroupedAggregate&) = delete;
+
+        // Folds in the elements appended since the last call and returns the accumulated value of every key so far.
+        const std::map<TKey, TAccumulate>& value()
+        {
+            enumerator_->push([this](T& element)
+            {
+                TKey key = keySelector_(element);
+                typename std::map<TKey, TAccumulate>::iterator group = groups_.find(key);
+
+                if (group == groups_.end())
+                {
+                    group = groups_.insert(std::make_pair(std::move(key), seed_)).first;
+                }
+
+                group->second = accumulator_(group->second, element);
+                ++watermark_;
+                return true;
+            });
+
+            return groups_;
+        }
+
+        size_t watermark() const
+        {
+            return watermark_;
+        }
+
+        void reset()
+        {
+            enumerator_->reset();
+            groups_.clear();
+            watermark_ = 0;
+        }
+
+    private:
+        std::shared_ptr<Enumerator<T> > enumerator_;
+        std::function<TKey(const T&)> keySelector_;
+        TAccumulate seed_;
+        std::function<TAccumulate (const TAccumulate&, const T&)> accumulator_;
+        std::map<TKey, TAccumulate> groups_;
+        size_t watermark_;
+    };
+}
+
+#endif
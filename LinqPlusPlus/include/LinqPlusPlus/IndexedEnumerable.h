@@ -0,0 +1,202 @@
+#ifndef LINQ_PLUSPLUS_INDEXED_ENUMERABLE_H
+#define LINQ_PLUSPLUS_INDEXED_ENUMERABLE_H
+
+#include "IEnumerable.h"
+#include "Enumerators/ContainerEnumerator.h"
+#include "Enumerators/PositionEnumerator.h"
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stddef.h>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace LinqPlusPlus
+{
+    // The elements of a query materialized once by IEnumerable::build_index, together with each one's key, for
+    // repeated lookups that don't scan. lookup, contains_key and contains find equal keys through a hash index, in
+    // constant time; range finds a span of keys through a sorted permutation, in logarithmic time. Each index is
+    // built on the first call that needs it, once even when many threads race to it, and only read afterwards, so
+    // the enumerable can be shared between threads like any other. Only the index a program uses has to be
+    // supported by the key: std::hash and == for the hash index, < for the sorted one. contains, which also works
+    // through an ENUMERABLE_PTR, scans instead if the key has no std::hash.
+    template <typename T, typename TKey>
+    class IndexedEnumerable: public IEnumerable<T>
+    {
+    public:
+        IndexedEnumerable(std::vector<T>&& elements, std::function<TKey(const T&)> keySelector)
+            : index_(std::make_shared<Index>())
+        {
+            index_->elements = std::make_shared<std::vector<T> >(std::move(elements));
+            index_->keySelector = keySelector;
+            index_->keys.reserve(index_->elements->size());
+            for (const T& element : *index_->elements)
+            {
+                index_->keys.push_back(keySelector(element));
+            }
+
+            std::shared_ptr<std::vector<T> > shared = index_->elements;
+            source_ = make_source<T>("build_index", [=]()
+            {
+                return std::make_shared<Enumerators::ContainerEnumerator<T, std::vector<T> > >(shared);
+            });
+        }
+
+        virtual ~IndexedEnumerable(){}
+
+        virtual std::shared_ptr<Enumerator<T> > enumerator() const override
+        {
+            return source_->enumerator();
+        }
+
+#ifdef LINQ_PLUSPLUS_INSTRUMENTATION
+        virtual Diagnostics::OperatorStatistics::Ptr statistics() const override
+        {
+            return source_->statistics();
+        }
+#endif
+
+        // The elements whose key equals key, in their original order.
+        ENUMERABLE_PTR(T) lookup(const TKey& key) const
+        {
+            std::shared_ptr<const HashIndex> index = hashed();
+            typename std::unordered_map<TKey, std::pair<size_t, size_t> >::const_iterator group = index->groups.find(key);
+            size_t begin = group == index->groups.end() ? 0 : group->second.first;
+            size_t end = group == index->groups.end() ? 0 : group->second.first + group->second.second;
+
+            return positions("lookup", std::shared_ptr<const std::vector<size_t> >(index, &index->grouped), begin, end);
+        }
+
+        bool contains_key(const TKey& key) const
+        {
+            std::shared_ptr<const HashIndex> index = hashed();
+            return index->groups.find(key) != index->groups.end();
+        }
+
+        // The elements with keys from low up to but not including high, in key order, and in their original order
+        // among equal keys.
+        ENUMERABLE_PTR(T) range(const TKey& low, const TKey& high) const
+        {
+            const Index& index = sorted();
+            const std::vector<TKey>& keys = index.keys;
+
+            std::vector<size_t>::const_iterator begin = std::lower_bound(index.ordered.begin(), index.ordered.end(), low,
+                [&](size_t position, const TKey& key){ return keys[position] < key; });
+            std::vector<size_t>::const_iterator end = std::lower_bound(begin, index.ordered.end(), high,
+                [&](size_t position, const TKey& key){ return keys[position] < key; });
+
+            return positions("range", std::shared_ptr<const std::vector<size_t> >(index_, &index.ordered),
+                static_cast<size_t>(begin - index.ordered.begin()), static_cast<size_t>(end - index.ordered.begin()));
+        }
+
+    protected:
+        virtual ENUMERABLE_PTR(T) candidates_equal_to(const T& value) const override
+        {
+            return candidates_equal_to(value, std::is_default_constructible<std::hash<TKey> >());
+        }
+
+    private:
+        // The positions of the elements grouped by key, and where each key's group starts and how long it is. Only
+        // ever made by hashed(), so keys without a std::hash can still use the rest.
+        struct HashIndex
+        {
+            std::vector<size_t> grouped;
+            std::unordered_map<TKey, std::pair<size_t, size_t> > groups;
+        };
+
+        struct Index
+        {
+            std::shared_ptr<std::vector<T> > elements;
+            std::vector<TKey> keys;
+            std::function<TKey(const T&)> keySelector;
+
+            std::once_flag hashOnce;
+            std::shared_ptr<const HashIndex> hashed;
+
+            // The positions of the elements ordered by key.
+            std::once_flag sortOnce;
+            std::vector<size_t> ordered;
+        };
+
+        ENUMERABLE_PTR(T) candidates_equal_to(const T& value, std::true_type) const
+        {
+            return lookup(index_->keySelector(value));
+        }
+
+        ENUMERABLE_PTR(T) candidates_equal_to(const T&, std::false_type) const
+        {
+            return nullptr;
+        }
+
+        std::shared_ptr<const HashIndex> hashed() const
+        {
+            Index& index = *index_;
+            std::call_once(index.hashOnce, [&]()
+            {
+                std::shared_ptr<HashIndex> hashed = std::make_shared<HashIndex>();
+
+                for (const TKey& key : index.keys)
+                {
+                    ++hashed->groups[key].second;
+                }
+
+                size_t start = 0;
+                for (std::pair<const TKey, std::pair<size_t, size_t> >& group : hashed->groups)
+                {
+                    group.second.first = start;
+                    start += group.second.second;
+                    group.second.second = 0;
+                }
+
+                hashed->grouped.resize(index.keys.size());
+                for (size_t i = 0; i < index.keys.size(); ++i)
+                {
+                    std::pair<size_t, size_t>& group = hashed->groups[index.keys[i]];
+                    hashed->grouped[group.first + group.second++] = i;
+                }
+
+                index.hashed = hashed;
+            });
+
+            return index.hashed;
+        }
+
+        const Index& sorted() const
+        {
+            Index& index = *index_;
+            std::call_once(index.sortOnce, [&]()
+            {
+                index.ordered.resize(index.keys.size());
+                for (size_t i = 0; i < index.ordered.size(); ++i)
+                {
+                    index.ordered[i] = i;
+                }
+
+                const std::vector<TKey>& keys = index.keys;
+                std::stable_sort(index.ordered.begin(), index.ordered.end(), [&](size_t x, size_t y)
+                {
+                    return keys[x] < keys[y];
+                });
+            });
+
+            return index;
+        }
+
+        ENUMERABLE_PTR(T) positions(const char* name, std::shared_ptr<const std::vector<size_t> > positions, size_t begin, size_t end) const
+        {
+            std::shared_ptr<std::vector<T> > elements = index_->elements;
+            return make_source<T>(name, [=]()
+            {
+                return std::make_shared<Enumerators::PositionEnumerator<T> >(elements, positions, begin, end);
+            });
+        }
+
+        std::shared_ptr<Index> index_;
+        ENUMERABLE_PTR(T) source_;
+    };
+}
+
+#endif
@@ -0,0 +1,149 @@
+#ifndef LINQ_PLUSPLUS_LOOKUP_H
+#define LINQ_PLUSPLUS_LOOKUP_H
+
+#include "FlatMap.h"
+#include <assert.h>
+#include <stddef.h>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace LinqPlusPlus
+{
+    // Every element of a sequence grouped by key, made by IEnumerable::to_lookup. The groups are laid out one after
+    // another in a single vector of values with an offset where each starts, so a key with many values doesn't
+    // need a container of its own and reading a group is a walk over contiguous memory. Groups are numbered in the
+    // order their keys first appeared, and keep their values in sequence order.
+    template <typename TKey, typename T>
+    class Lookup
+    {
+    public:
+        // The values of one group.
+        class Values
+        {
+        public:
+            Values(const T* first, const T* last)
+                : first_(first)
+                , last_(last)
+            {
+            }
+
+            const T* begin() const
+            {
+                return first_;
+            }
+
+            const T* end() const
+            {
+                return last_;
+            }
+
+            size_t size() const
+            {
+                return static_cast<size_t>(last_ - first_);
+            }
+
+            bool empty() const
+            {
+                return first_ == last_;
+            }
+
+            const T& operator[](size_t index) const
+            {
+                assert(index < size());
+                return first_[index];
+            }
+
+        private:
+            const T* first_;
+            const T* last_;
+        };
+
+        Lookup()
+            : offsets_(1, 0)
+        {
+        }
+
+        // Groups elements, where groupOf[i] is the group of elements[i] and groups numbers every distinct key.
+        Lookup(FlatMap<TKey, size_t>&& groups, const std::vector<size_t>& groupOf, std::vector<T>&& elements)
+            : groups_(std::move(groups))
+            , offsets_(groups_.size() + 1, 0)
+        {
+            for (size_t group : groupOf)
+            {
+                ++offsets_[group + 1];
+            }
+
+            for (size_t group = 0; group < groups_.size(); ++group)
+            {
+                offsets_[group + 1] += offsets_[group];
+            }
+
+            place(groupOf, elements, std::is_default_constructible<T>());
+        }
+
+        // The number of distinct keys.
+        size_t size() const
+        {
+            return groups_.size();
+        }
+
+        bool contains(const TKey& key) const
+        {
+            return groups_.contains(key);
+        }
+
+        // The values with the given key, none if there are none.
+        Values operator[](const TKey& key) const
+        {
+            const size_t* group = groups_.find(key);
+            return group == nullptr ? Values(nullptr, nullptr) : values(*group);
+        }
+
+        const TKey& key(size_t group) const
+        {
+            return (groups_.begin() + group)->first;
+        }
+
+        Values values(size_t group) const
+        {
+            const T* first = values_.data();
+            return Values(first + offsets_[group], first + offsets_[group + 1]);
+        }
+
+    private:
+        // Moves each element straight to the next free place in its group.
+        void place(const std::vector<size_t>& groupOf, std::vector<T>& elements, std::true_type)
+        {
+            std::vector<size_t> next(offsets_.begin(), offsets_.end() - 1);
+            values_.resize(elements.size());
+            for (size_t i = 0; i < groupOf.size(); ++i)
+            {
+                values_[next[groupOf[i]]++] = std::move(elements[i]);
+            }
+        }
+
+        // Without a default to overwrite, sorts the positions by group first and then moves the elements in order.
+        void place(const std::vector<size_t>& groupOf, std::vector<T>& elements, std::false_type)
+        {
+            std::vector<size_t> order(groupOf.size());
+            std::vector<size_t> next(offsets_.begin(), offsets_.end() - 1);
+            for (size_t i = 0; i < groupOf.size(); ++i)
+            {
+                order[next[groupOf[i]]++] = i;
+            }
+
+            values_.reserve(elements.size());
+            for (size_t i : order)
+            {
+                values_.push_back(std::move(elements[i]));
+            }
+        }
+
+        FlatMap<TKey, size_t> groups_;
+        std::vector<size_t> offsets_;
+        std::vector<T> values_;
+    };
+}
+
+#endif
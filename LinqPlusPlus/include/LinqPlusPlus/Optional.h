@@ -0,0 +1,180 @@
+#ifndef LINQ_PLUSPLUS_OPTIONAL_H
+#define LINQ_PLUSPLUS_OPTIONAL_H
+
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace LinqPlusPlus
+{
+#if defined(__GNUC__) && !defined(__clang__)
+// Whether the storage holds a value is tracked by hasValue_, which GCC can lose sight of once an optional has been
+// moved from or assigned to, and then warns about reading the storage of one that's empty.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+    // Either holds a value or is empty; returned by the try_* operators so a miss doesn't have to throw. The value
+    // lives inline, so neither a hit nor a miss allocates.
+    template <typename T>
+    class Optional
+    {
+    public:
+        Optional()
+            : hasValue_(false)
+        {
+        }
+
+        Optional(const T& value)
+            : hasValue_(true)
+        {
+            new (&storage_) T(value);
+        }
+
+        Optional(T&& value)
+            : hasValue_(true)
+        {
+            new (&storage_) T(std::move(value));
+        }
+
+        Optional(const Optional& other)
+            : hasValue_(other.hasValue_)
+        {
+            if (hasValue_)
+            {
+                new (&storage_) T(*other);
+            }
+        }
+
+        Optional(Optional&& other)
+            : hasValue_(other.hasValue_)
+        {
+            if (hasValue_)
+            {
+                new (&storage_) T(std::move(*other));
+            }
+        }
+
+        ~Optional()
+        {
+            reset();
+        }
+
+        Optional& operator=(const Optional& rhs)
+        {
+            if (this != &rhs)
+            {
+                reset();
+
+                if (rhs.hasValue_)
+                {
+                    new (&storage_) T(*rhs);
+                    hasValue_ = true;
+                }
+            }
+
+            return *this;
+        }
+
+        Optional& operator=(Optional&& rhs)
+        {
+            if (this != &rhs)
+            {
+                reset();
+
+                if (rhs.hasValue_)
+                {
+                    new (&storage_) T(std::move(*rhs));
+                    hasValue_ = true;
+                }
+            }
+
+            return *this;
+        }
+
+        bool has_value() const
+        {
+            return hasValue_;
+        }
+
+        explicit operator bool() const
+        {
+            return hasValue_;
+        }
+
+        T& value()
+        {
+            if (!hasValue_)
+            {
+                throw std::runtime_error("Invalid operation: the optional has no value");
+            }
+
+            return **this;
+        }
+
+        const T& value() const
+        {
+            if (!hasValue_)
+            {
+                throw std::runtime_error("Invalid operation: the optional has no value");
+            }
+
+            return **this;
+        }
+
+        T value_or(const T& defaultValue) const &
+        {
+            return hasValue_ ? **this : defaultValue;
+        }
+
+        T value_or(const T& defaultValue) &&
+        {
+            if (hasValue_)
+            {
+                return std::move(**this);
+            }
+
+            return defaultValue;
+        }
+
+        void reset()
+        {
+            if (hasValue_)
+            {
+                (**this).~T();
+                hasValue_ = false;
+            }
+        }
+
+        T& operator*()
+        {
+            return *reinterpret_cast<T*>(&storage_);
+        }
+
+        const T& operator*() const
+        {
+            return *reinterpret_cast<const T*>(&storage_);
+        }
+
+        T* operator->()
+        {
+            return &**this;
+        }
+
+        const T* operator->() const
+        {
+            return &**this;
+        }
+
+    private:
+        typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type storage_;
+        bool hasValue_;
+    };
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+}
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef LINQ_PLUSPLUS_HYPER_LOG_LOG_H
+#define LINQ_PLUSPLUS_HYPER_LOG_LOG_H
+
+#include <functional>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace LinqPlusPlus
+{
+    namespace Sketches
+    {
+        // Estimates the number of distinct values added, in 2^precision bytes whatever the number of values. The
+        // standard error is about 1.04 / sqrt(2^precision): 0.8% at the default precision of 14, which takes 16KB.
+        // Sketches of the same precision can be merged, e.g. to combine sketches built over chunks of a sequence
+        // in parallel, or to fold a sketch of newly appended elements into a running one.
+        class HyperLogLog
+        {
+        public:
+            // Throws std::out_of_range unless 4 <= precision <= 18.
+            explicit HyperLogLog(unsigned precision = 14);
+
+            // Values are hashed with std::hash.
+            template <typename T>
+            void add(const T& value)
+            {
+                add_hash(static_cast<uint64_t>(std::hash<T>()(value)));
+            }
+
+            // Hashes are mixed again before use, so a weak hash such as the identity std::hash<int> is fine.
+            void add_hash(uint64_t hash);
+
+            // Throws std::runtime_error if the precisions differ.
+            void merge(const HyperLogLog& other);
+
+            double estimate() const;
+
+            unsigned precision() const;
+
+        private:
+            unsigned precision_;
+            std::vector<uint8_t> registers_;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,201 @@
+#ifndef LINQ_PLUSPLUS_SERIALIZER_H
+#define LINQ_PLUSPLUS_SERIALIZER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace LinqPlusPlus
+{
+    namespace Spill
+    {
+        // How elements are written to and read back from spill files, and roughly how much memory one takes up while
+        // it's buffered. Trivially copyable types, strings, pairs and vectors of these are covered; specialize it
+        // for other element types that need to be spilled. Out and In are SpillFile or anything else with the same
+        // write and read members.
+        template <typename T, typename Enable = void>
+        struct Serializer;
+
+        template <typename T>
+        struct Serializer<T, typename std::enable_if<std::is_trivially_copyable<T>::value>::type>
+        {
+            static size_t footprint(const T&)
+            {
+                return sizeof(T);
+            }
+
+            template <typename Out>
+            static void write(Out& out, const T& value)
+            {
+                out.write(&value, sizeof(T));
+            }
+
+            template <typename In>
+            static bool read(In& in, T& value)
+            {
+                return in.read(&value, sizeof(T));
+            }
+        };
+
+        template <>
+        struct Serializer<std::string>
+        {
+            static size_t footprint(const std::string& value)
+            {
+                return sizeof(std::string) + value.capacity();
+            }
+
+            template <typename Out>
+            static void write(Out& out, const std::string& value)
+            {
+                uint64_t length = value.size();
+                out.write(&length, sizeof(length));
+                out.write(value.data(), value.size());
+            }
+
+            template <typename In>
+            static bool read(In& in, std::string& value)
+            {
+                uint64_t length;
+
+                if (!in.read(&length, sizeof(length)))
+                {
+                    return false;
+                }
+
+                value.resize(static_cast<size_t>(length));
+                return length == 0 || in.read(&value[0], value.size());
+            }
+        };
+
+        template <typename A, typename B>
+        struct Serializer<std::pair<A, B>, typename std::enable_if<!std::is_trivially_copyable<std::pair<A, B> >::value>::type>
+        {
+            static size_t footprint(const std::pair<A, B>& value)
+            {
+                return Serializer<A>::footprint(value.first) + Serializer<B>::footprint(value.second);
+            }
+
+            template <typename Out>
+            static void write(Out& out, const std::pair<A, B>& value)
+            {
+                Serializer<A>::write(out, value.first);
+                Serializer<B>::write(out, value.second);
+            }
+
+            template <typename In>
+            static bool read(In& in, std::pair<A, B>& value)
+            {
+                return Serializer<A>::read(in, value.first) && Serializer<B>::read(in, value.second);
+            }
+        };
+
+        template <typename T>
+        struct Serializer<std::vector<T> >
+        {
+            static size_t footprint(const std::vector<T>& value)
+            {
+                size_t size = sizeof(std::vector<T>) + (value.capacity() - value.size()) * sizeof(T);
+                for (const T& element : value)
+                {
+                    size += Serializer<T>::footprint(element);
+                }
+
+                return size;
+            }
+
+            template <typename Out>
+            static void write(Out& out, const std::vector<T>& value)
+            {
+                uint64_t length = value.size();
+                out.write(&length, sizeof(length));
+
+                for (const T& element : value)
+                {
+                    Serializer<T>::write(out, element);
+                }
+            }
+
+            template <typename In>
+            static bool read(In& in, std::vector<T>& value)
+            {
+                uint64_t length;
+
+                if (!in.read(&length, sizeof(length)))
+                {
+                    return false;
+                }
+
+                value.resize(static_cast<size_t>(length));
+                for (T& element : value)
+                {
+                    if (!Serializer<T>::read(in, element))
+                    {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+        };
+
+        // FNV-1a over the serialized form of a value. Used to hash partition by key without requiring std::hash for
+        // the key type, so equal keys must serialize to the same bytes (padding in a key struct would break this).
+        // Floating-point keys have their zeros normalized, since 0.0 and -0.0 are equal but differ in their sign
+        // bit; floating-point members of other keys don't.
+        class SerializedHash
+        {
+        public:
+            SerializedHash()
+                : hash_(14695981039346656037ULL)
+            {
+            }
+
+            template <typename T>
+            static uint64_t of(const T& value)
+            {
+                SerializedHash hash;
+                Serializer<T>::write(hash, normalized(value));
+                return hash.hash_;
+            }
+
+            void write(const void* data, size_t size)
+            {
+                const unsigned char* bytes = static_cast<const unsigned char*>(data);
+                for (size_t i = 0; i < size; ++i)
+                {
+                    hash_ = (hash_ ^ bytes[i]) * 1099511628211ULL;
+                }
+            }
+
+        private:
+            template <typename T>
+            static const T& normalized(const T& value)
+            {
+                return value;
+            }
+
+            static float normalized(float value)
+            {
+                return value == 0 ? 0.0f : value;
+            }
+
+            static double normalized(double value)
+            {
+                return value == 0 ? 0.0 : value;
+            }
+
+            static long double normalized(long double value)
+            {
+                return value == 0 ? 0.0L : value;
+            }
+
+            uint64_t hash_;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef LINQ_PLUSPLUS_SPILL_FILE_H
+#define LINQ_PLUSPLUS_SPILL_FILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+namespace LinqPlusPlus
+{
+    namespace Spill
+    {
+        // An anonymous temporary file that operators over a memory budget write their overflow to. Writes are
+        // buffered, and the file is removed by the operating system when it's closed, even if the process dies.
+        class SpillFile
+        {
+        public:
+            // Throws std::runtime_error if no temporary file can be created.
+            SpillFile();
+            ~SpillFile();
+
+            SpillFile(const SpillFile&) = delete;
+            SpillFile& operator=(const SpillFile&) = delete;
+
+            // Throws std::runtime_error if the write fails, typically because the disk is full.
+            void write(const void* data, size_t size);
+
+            // Returns false if the end of the file was reached first.
+            bool read(void* data, size_t size);
+
+            // Moves back to the start of the file, so what was written can be read.
+            void rewind();
+
+            uint64_t bytes_written() const;
+
+            // Spill files created by every thread since the program started.
+            static uint64_t created();
+
+        private:
+            FILE* file_;
+            uint64_t bytesWritten_;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,99 @@
+#include "LinqPlusPlus/Coroutines/FrameArena.h"
+#include <new>
+
+namespace
+{
+    const size_t Granularity = 64;
+    const size_t SizeClasses = 64;
+    const size_t MaxCachedFrames = 16;
+
+    struct FreeFrame
+    {
+        FreeFrame* next;
+    };
+
+    struct FreeList
+    {
+        FreeFrame* head;
+        size_t count;
+    };
+
+    struct ThreadCache
+    {
+        ThreadCache()
+        {
+            for (size_t i = 0; i < SizeClasses; ++i)
+            {
+                lists[i].head = nullptr;
+                lists[i].count = 0;
+            }
+        }
+
+        ~ThreadCache()
+        {
+            for (size_t i = 0; i < SizeClasses; ++i)
+            {
+                while (lists[i].head != nullptr)
+                {
+                    FreeFrame* frame = lists[i].head;
+                    lists[i].head = frame->next;
+                    ::operator delete(frame);
+                }
+            }
+        }
+
+        FreeList lists[SizeClasses];
+    };
+
+    thread_local ThreadCache cache;
+
+    size_t size_class(size_t size)
+    {
+        return size == 0 ? 0 : (size - 1) / Granularity;
+    }
+}
+
+namespace LinqPlusPlus
+{
+    namespace Coroutines
+    {
+        void* FrameArena::allocate(size_t size)
+        {
+            size_t sizeClass = size_class(size);
+
+            if (sizeClass >= SizeClasses)
+            {
+                return ::operator new(size);
+            }
+
+            FreeList& list = cache.lists[sizeClass];
+
+            if (list.head == nullptr)
+            {
+                return ::operator new((sizeClass + 1) * Granularity);
+            }
+
+            FreeFrame* frame = list.head;
+            list.head = frame->next;
+            --list.count;
+            return frame;
+        }
+
+        void FrameArena::deallocate(void* frame, size_t size)
+        {
+            size_t sizeClass = size_class(size);
+
+            if (sizeClass >= SizeClasses || cache.lists[sizeClass].count >= MaxCachedFrames)
+            {
+                ::operator delete(frame);
+                return;
+            }
+
+            FreeList& list = cache.lists[sizeClass];
+            FreeFrame* free = static_cast<FreeFrame*>(frame);
+            free->next = list.head;
+            list.head = free;
+            ++list.count;
+        }
+    }
+}
@@ -0,0 +1,97 @@
+#include "LinqPlusPlus/Diagnostics/Accounting.h"
+
+#ifdef LINQ_PLUSPLUS_INSTRUMENTATION
+#include "LinqPlusPlus/Diagnostics/CountingAllocator.h"
+#endif
+
+namespace
+{
+    thread_local uint64_t allocationCount = 0;
+    thread_local uint64_t allocatedBytes = 0;
+    thread_local uint64_t copyCount = 0;
+    thread_local uint64_t moveCount = 0;
+}
+
+namespace LinqPlusPlus
+{
+    namespace Diagnostics
+    {
+        uint64_t allocations()
+        {
+            return allocationCount;
+        }
+
+        uint64_t allocated_bytes()
+        {
+            return allocatedBytes;
+        }
+
+        void record_allocation(uint64_t bytes)
+        {
+            ++allocationCount;
+            allocatedBytes += bytes;
+        }
+
+        Tracked::Tracked()
+            : value_(0)
+        {
+        }
+
+        Tracked::Tracked(int value)
+            : value_(value)
+        {
+        }
+
+        Tracked::Tracked(const Tracked& other)
+            : value_(other.value_)
+        {
+            ++copyCount;
+        }
+
+        Tracked::Tracked(Tracked&& other)
+            : value_(other.value_)
+        {
+            ++moveCount;
+        }
+
+        Tracked::~Tracked()
+        {
+        }
+
+        Tracked& Tracked::operator=(const Tracked& rhs)
+        {
+            value_ = rhs.value_;
+            ++copyCount;
+            return *this;
+        }
+
+        Tracked& Tracked::operator=(Tracked&& rhs)
+        {
+            value_ = rhs.value_;
+            ++moveCount;
+            return *this;
+        }
+
+        uint64_t Tracked::copies()
+        {
+            return copyCount;
+        }
+
+        uint64_t Tracked::moves()
+        {
+            return moveCount;
+        }
+
+        Usage Usage::now()
+        {
+            Usage usage = { allocationCount, allocatedBytes, copyCount, moveCount };
+            return usage;
+        }
+
+        Usage Usage::operator-(const Usage& rhs) const
+        {
+            Usage usage = { allocations - rhs.allocations, bytes - rhs.bytes, copies - rhs.copies, moves - rhs.moves };
+            return usage;
+        }
+    }
+}
@@ -0,0 +1,148 @@
+#include "LinqPlusPlus/Diagnostics/OperatorStatistics.h"
+#include <sstream>
+
+namespace LinqPlusPlus
+{
+    namespace Diagnostics
+    {
+        OperatorStatistics::OperatorStatistics(const std::string& name, const std::vector<Ptr>& inputs)
+            : name_(name)
+            , inputs_(inputs)
+            , elementsOut_(0)
+            , moveNextCalls_(0)
+            , calls_(0)
+            , sampledCalls_(0)
+            , sampledNanoseconds_(0)
+            , bytesAllocated_(0)
+        {
+        }
+
+        OperatorStatistics::OperatorStatistics(const OperatorStatistics& other)
+            : name_(other.name_)
+            , inputs_(other.inputs_)
+            , elementsOut_(other.elementsOut_.load())
+            , moveNextCalls_(other.moveNextCalls_.load())
+            , calls_(other.calls_.load())
+            , sampledCalls_(other.sampledCalls_.load())
+            , sampledNanoseconds_(other.sampledNanoseconds_.load())
+            , bytesAllocated_(other.bytesAllocated_.load())
+        {
+        }
+
+        OperatorStatistics::~OperatorStatistics()
+        {
+        }
+
+        OperatorStatistics& OperatorStatistics::operator=(const OperatorStatistics& rhs)
+        {
+            name_ = rhs.name_;
+            inputs_ = rhs.inputs_;
+            elementsOut_ = rhs.elementsOut_.load();
+            moveNextCalls_ = rhs.moveNextCalls_.load();
+            calls_ = rhs.calls_.load();
+            sampledCalls_ = rhs.sampledCalls_.load();
+            sampledNanoseconds_ = rhs.sampledNanoseconds_.load();
+            bytesAllocated_ = rhs.bytesAllocated_.load();
+            return *this;
+        }
+
+        const std::string& OperatorStatistics::name() const
+        {
+            return name_;
+        }
+
+        const std::vector<OperatorStatistics::Ptr>& OperatorStatistics::inputs() const
+        {
+            return inputs_;
+        }
+
+        uint64_t OperatorStatistics::elements_in() const
+        {
+            if (inputs_.empty())
+            {
+                return elementsOut_;
+            }
+
+            uint64_t elementsIn = 0;
+            for (auto it = inputs_.begin(); it != inputs_.end(); ++it)
+            {
+                elementsIn += (*it)->elements_out();
+            }
+
+            return elementsIn;
+        }
+
+        uint64_t OperatorStatistics::elements_out() const
+        {
+            return elementsOut_;
+        }
+
+        uint64_t OperatorStatistics::move_next_calls() const
+        {
+            return moveNextCalls_;
+        }
+
+        uint64_t OperatorStatistics::nanoseconds() const
+        {
+            uint64_t sampledCalls = sampledCalls_.load(std::memory_order_relaxed);
+            return sampledCalls == 0 ? 0 : sampledNanoseconds_.load(std::memory_order_relaxed) * calls_.load(std::memory_order_relaxed) / sampledCalls;
+        }
+
+        uint64_t OperatorStatistics::self_nanoseconds() const
+        {
+            uint64_t inputs = 0;
+            for (auto it = inputs_.begin(); it != inputs_.end(); ++it)
+            {
+                inputs += (*it)->nanoseconds();
+            }
+
+            uint64_t total = nanoseconds();
+            return total > inputs ? total - inputs : 0;
+        }
+
+        uint64_t OperatorStatistics::bytes_allocated() const
+        {
+            return bytesAllocated_;
+        }
+
+        uint64_t OperatorStatistics::self_bytes_allocated() const
+        {
+            uint64_t inputs = 0;
+            for (auto it = inputs_.begin(); it != inputs_.end(); ++it)
+            {
+                inputs += (*it)->bytes_allocated();
+            }
+
+            uint64_t bytesAllocated = bytes_allocated();
+            return bytesAllocated > inputs ? bytesAllocated - inputs : 0;
+        }
+
+        void OperatorStatistics::visit(const Visitor& visitor, size_t depth) const
+        {
+            visitor(*this, depth);
+
+            for (auto it = inputs_.begin(); it != inputs_.end(); ++it)
+            {
+                (*it)->visit(visitor, depth + 1);
+            }
+        }
+
+        std::string OperatorStatistics::explain() const
+        {
+            std::ostringstream out;
+
+            visit([&](const OperatorStatistics& statistics, size_t depth)
+            {
+                out << std::string(depth * 2, ' ') << statistics.name()
+                    << " (in=" << statistics.elements_in()
+                    << " out=" << statistics.elements_out()
+                    << " move_next=" << statistics.move_next_calls()
+                    << " time=" << statistics.nanoseconds() << "ns"
+                    << " self=" << statistics.self_nanoseconds() << "ns"
+                    << " alloc=" << statistics.self_bytes_allocated() << "B)\n";
+            });
+
+            return out.str();
+        }
+    }
+}
@@ -0,0 +1,251 @@
+#include "LinqPlusPlus/Diagnostics/Trace.h"
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    struct Span
+    {
+        const char* category;
+        uint32_t name;
+        uint64_t start;
+        uint64_t end;
+    };
+
+    struct ThreadBuffer
+    {
+        ThreadBuffer()
+            : id(0)
+            , generation(0)
+            , next(0)
+            , wrapped(false)
+            , owned(true)
+        {
+        }
+
+        uint32_t id;
+        uint64_t generation;
+        std::vector<Span> spans;
+        size_t next;
+        bool wrapped;
+        bool owned;
+    };
+
+    // Gives the thread's buffer back when the thread exits, so a later thread can take it over once its spans are
+    // no longer wanted.
+    struct LocalBuffer
+    {
+        LocalBuffer()
+            : buffer(nullptr)
+        {
+        }
+
+        ~LocalBuffer();
+
+        ThreadBuffer* buffer;
+    };
+
+    std::mutex registryMutex;
+    std::vector<std::unique_ptr<ThreadBuffer> > buffers;
+    std::vector<std::string> names;
+    std::map<std::string, uint32_t> nameIds;
+    size_t spansPerThread = 1 << 16;
+    uint32_t threadsInGeneration = 0;
+    std::atomic<uint64_t> generation(0);
+    const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+    thread_local LocalBuffer local;
+
+    LocalBuffer::~LocalBuffer()
+    {
+        if (buffer != nullptr)
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            buffer->owned = false;
+        }
+    }
+
+    // Buffers are never freed while tracing, since other threads may be writing to them. A thread whose buffer
+    // belongs to an earlier trace clears it and joins the current one; a new thread takes over a buffer left behind
+    // by a thread that has exited, unless it holds spans of the current trace.
+    ThreadBuffer& register_thread()
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+
+        uint64_t current = generation.load();
+        ThreadBuffer* buffer = local.buffer;
+
+        for (auto it = buffers.begin(); buffer == nullptr && it != buffers.end(); ++it)
+        {
+            if (!(*it)->owned && (*it)->generation != current)
+            {
+                buffer = it->get();
+            }
+        }
+
+        if (buffer == nullptr)
+        {
+            buffers.push_back(std::unique_ptr<ThreadBuffer>(new ThreadBuffer()));
+            buffer = buffers.back().get();
+        }
+
+        buffer->id = threadsInGeneration++;
+        buffer->generation = current;
+        buffer->spans.assign(spansPerThread, Span());
+        buffer->next = 0;
+        buffer->wrapped = false;
+        buffer->owned = true;
+        local.buffer = buffer;
+
+        return *buffer;
+    }
+
+    void write_escaped(std::ostream& out, const std::string& value)
+    {
+        static const char* hex = "0123456789abcdef";
+
+        for (auto it = value.begin(); it != value.end(); ++it)
+        {
+            unsigned char c = static_cast<unsigned char>(*it);
+            if (c == '"' || c == '\\')
+            {
+                out << '\\' << *it;
+            }
+            else if (c < 0x20)
+            {
+                out << "\\u00" << hex[c >> 4] << hex[c & 0xF];
+            }
+            else
+            {
+                out << *it;
+            }
+        }
+    }
+
+    void write_timestamp(std::ostream& out, uint64_t nanoseconds)
+    {
+        // Chrome trace timestamps are in microseconds.
+        out << nanoseconds / 1000 << '.' << static_cast<char>('0' + nanoseconds / 100 % 10)
+            << static_cast<char>('0' + nanoseconds / 10 % 10) << static_cast<char>('0' + nanoseconds % 10);
+    }
+}
+
+namespace LinqPlusPlus
+{
+    namespace Diagnostics
+    {
+        std::atomic<bool> Trace::enabled_(false);
+
+        void Trace::start(size_t capacity)
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+
+            spansPerThread = capacity > 0 ? capacity : 1;
+            threadsInGeneration = 0;
+            ++generation;
+            enabled_.store(true);
+        }
+
+        void Trace::stop()
+        {
+            enabled_.store(false);
+        }
+
+        uint32_t Trace::intern(const std::string& name)
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+
+            auto found = nameIds.find(name);
+            if (found != nameIds.end())
+            {
+                return found->second;
+            }
+
+            uint32_t id = static_cast<uint32_t>(names.size());
+            names.push_back(name);
+            nameIds[name] = id;
+            return id;
+        }
+
+        uint64_t Trace::now()
+        {
+            auto elapsed = std::chrono::steady_clock::now() - epoch;
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) + 1;
+        }
+
+        void Trace::record(const char* category, uint32_t name, uint64_t start, uint64_t end)
+        {
+            ThreadBuffer* buffer = local.buffer;
+            if (buffer == nullptr || buffer->generation != generation.load(std::memory_order_relaxed))
+            {
+                buffer = &register_thread();
+            }
+
+            Span& span = buffer->spans[buffer->next];
+            span.category = category;
+            span.name = name;
+            span.start = start;
+            span.end = end;
+
+            if (++buffer->next == buffer->spans.size())
+            {
+                buffer->next = 0;
+                buffer->wrapped = true;
+            }
+        }
+
+        void Trace::write(std::ostream& out)
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+
+            out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+            bool first = true;
+            for (auto buffer = buffers.begin(); buffer != buffers.end(); ++buffer)
+            {
+                if ((*buffer)->generation != generation.load())
+                {
+                    continue;
+                }
+
+                out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << (*buffer)->id
+                    << ",\"args\":{\"name\":\"thread " << (*buffer)->id << "\"}}";
+                first = false;
+
+                size_t count = (*buffer)->wrapped ? (*buffer)->spans.size() : (*buffer)->next;
+                size_t index = (*buffer)->wrapped ? (*buffer)->next : 0;
+
+                for (size_t i = 0; i < count; ++i, index = (index + 1) % (*buffer)->spans.size())
+                {
+                    const Span& span = (*buffer)->spans[index];
+
+                    out << ",\n{\"name\":\"";
+                    write_escaped(out, span.name < names.size() ? names[span.name] : std::string("?"));
+                    out << "\",\"cat\":\"" << span.category << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << (*buffer)->id << ",\"ts\":";
+                    write_timestamp(out, span.start);
+                    out << ",\"dur\":";
+                    write_timestamp(out, span.end > span.start ? span.end - span.start : 0);
+                    out << "}";
+                }
+            }
+
+            out << "\n]}\n";
+        }
+
+        bool Trace::write(const std::string& path)
+        {
+            std::ofstream out(path.c_str());
+            if (!out)
+            {
+                return false;
+            }
+
+            write(out);
+            return static_cast<bool>(out);
+        }
+    }
+}
@@ -0,0 +1,103 @@
+#include "LinqPlusPlus/Sketches/HyperLogLog.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+    // The splitmix64 finalizer, so that every bit of the hash depends on every bit of the value.
+    uint64_t mix(uint64_t hash)
+    {
+        hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+        return hash ^ (hash >> 31);
+    }
+
+    unsigned leading_zeros(uint64_t bits)
+    {
+#if defined(__GNUC__)
+        return bits == 0 ? 64 : static_cast<unsigned>(__builtin_clzll(bits));
+#else
+        unsigned zeros = 0;
+        for (uint64_t mask = 1ULL << 63; mask != 0 && (bits & mask) == 0; mask >>= 1)
+        {
+            ++zeros;
+        }
+
+        return zeros;
+#endif
+    }
+}
+
+namespace LinqPlusPlus
+{
+    namespace Sketches
+    {
+        HyperLogLog::HyperLogLog(unsigned precision)
+            : precision_(precision)
+        {
+            if (precision < 4 || precision > 18)
+            {
+                throw std::out_of_range("HyperLogLog precision must be between 4 and 18");
+            }
+
+            registers_.resize(size_t(1) << precision);
+        }
+
+        void HyperLogLog::add_hash(uint64_t hash)
+        {
+            hash = mix(hash);
+
+            // The top bits pick a register, which keeps the longest run of leading zeros seen in the rest.
+            size_t index = static_cast<size_t>(hash >> (64 - precision_));
+            uint8_t rank = static_cast<uint8_t>(std::min(leading_zeros(hash << precision_), 64 - precision_) + 1);
+
+            if (registers_[index] < rank)
+            {
+                registers_[index] = rank;
+            }
+        }
+
+        void HyperLogLog::merge(const HyperLogLog& other)
+        {
+            if (other.precision_ != precision_)
+            {
+                throw std::runtime_error("Invalid operation: cannot merge HyperLogLog sketches of different precisions");
+            }
+
+            for (size_t i = 0; i < registers_.size(); ++i)
+            {
+                registers_[i] = std::max(registers_[i], other.registers_[i]);
+            }
+        }
+
+        double HyperLogLog::estimate() const
+        {
+            double m = static_cast<double>(registers_.size());
+            double alpha = m == 16 ? 0.673 : m == 32 ? 0.697 : m == 64 ? 0.709 : 0.7213 / (1.0 + 1.079 / m);
+
+            double sum = 0;
+            size_t zeros = 0;
+            for (uint8_t rank : registers_)
+            {
+                sum += std::ldexp(1.0, -rank);
+                zeros += rank == 0 ? 1 : 0;
+            }
+
+            double estimate = alpha * m * m / sum;
+
+            // Small cardinalities leave registers empty, and counting those is more accurate.
+            if (estimate <= 2.5 * m && zeros > 0)
+            {
+                return m * std::log(m / static_cast<double>(zeros));
+            }
+
+            return estimate;
+        }
+
+        unsigned HyperLogLog::precision() const
+        {
+            return precision_;
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#include "LinqPlusPlus/Spill/SpillFile.h"
+#include <atomic>
+#include <stdexcept>
+
+namespace
+{
+    std::atomic<uint64_t> filesCreated(0);
+}
+
+namespace LinqPlusPlus
+{
+    namespace Spill
+    {
+        SpillFile::SpillFile()
+            : file_(tmpfile())
+            , bytesWritten_(0)
+        {
+            if (file_ == nullptr)
+            {
+                throw std::runtime_error("Unable to create a temporary file to spill to");
+            }
+
+            filesCreated.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        SpillFile::~SpillFile()
+        {
+            fclose(file_);
+        }
+
+        void SpillFile::write(const void* data, size_t size)
+        {
+            if (fwrite(data, 1, size, file_) != size)
+            {
+                throw std::runtime_error("Unable to write to a temporary spill file");
+            }
+
+            bytesWritten_ += size;
+        }
+
+        bool SpillFile::read(void* data, size_t size)
+        {
+            return fread(data, 1, size, file_) == size;
+        }
+
+        void SpillFile::rewind()
+        {
+            if (fflush(file_) != 0 || fseek(file_, 0, SEEK_SET) != 0)
+            {
+                throw std::runtime_error("Unable to rewind a temporary spill file");
+            }
+        }
+
+        uint64_t SpillFile::bytes_written() const
+        {
+            return bytesWritten_;
+        }
+
+        uint64_t SpillFile::created()
+        {
+            return filesCreated.load(std::memory_order_relaxed);
+        }
+    }
+}
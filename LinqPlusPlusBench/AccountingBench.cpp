@@ -0,0 +1,103 @@
+#include "BenchmarkData.h"
+#include "LinqPlusPlus/Enumerable.h"
+#include "LinqPlusPlus/Diagnostics/Accounting.h"
+
+#ifndef LINQ_PLUSPLUS_INSTRUMENTATION
+#include "LinqPlusPlus/Diagnostics/CountingAllocator.h"
+#endif
+
+using namespace LinqPlusPlus;
+using namespace LinqPlusPlus::Diagnostics;
+
+// Runs queries over Tracked elements and reports allocations and element copies per element next to the timings,
+// so a regression in either shows up in the same JSON as the ns_per_element it causes. The budgets themselves are
+// enforced by AccountingTest in LinqPlusPlusTest.
+
+namespace
+{
+    std::vector<Tracked> make_tracked(int64_t size)
+    {
+        std::vector<Tracked> data;
+        data.reserve(static_cast<size_t>(size));
+
+        for (int64_t i = 0; i < size; ++i)
+        {
+            data.push_back(Tracked(static_cast<int>(Bench::scramble(static_cast<size_t>(i)))));
+        }
+
+        return data;
+    }
+
+    void set_accounting_counters(benchmark::State& state, const Usage& usage)
+    {
+        double elements = static_cast<double>(state.iterations()) * state.range(0);
+
+        state.counters["allocations_per_element"] = usage.allocations / elements;
+        state.counters["copies_per_element"] = usage.copies / elements;
+        Bench::set_counters(state, state.range(0));
+    }
+
+    bool is_even(const Tracked& t)
+    {
+        return t.value() % 2 == 0;
+    }
+}
+
+void Accounting_Where(benchmark::State& state)
+{
+    auto collection = Enumerable::from(make_tracked(state.range(0)));
+    auto query = collection->where(&is_even);
+
+    Usage before = Usage::now();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(query->count());
+    }
+
+    set_accounting_counters(state, Usage::now() - before);
+}
+
+void Accounting_Select(benchmark::State& state)
+{
+    auto collection = Enumerable::from(make_tracked(state.range(0)));
+    auto query = collection->select<int>([](const Tracked& t){ return t.value(); });
+
+    Usage before = Usage::now();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(query->any([](const int& n){ return n < 0; }));
+    }
+
+    set_accounting_counters(state, Usage::now() - before);
+}
+
+void Accounting_Distinct(benchmark::State& state)
+{
+    auto collection = Enumerable::from(make_tracked(state.range(0)));
+
+    Usage before = Usage::now();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(collection->distinct()->count());
+    }
+
+    set_accounting_counters(state, Usage::now() - before);
+}
+
+void Accounting_ToMap(benchmark::State& state)
+{
+    auto collection = Enumerable::from(make_tracked(state.range(0)));
+
+    Usage before = Usage::now();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(collection->to_map<int>([](const Tracked& t){ return t.value(); }).size());
+    }
+
+    set_accounting_counters(state, Usage::now() - before);
+}
+
+BENCHMARK(Accounting_Where)->RangeMultiplier(100)->Range(100, 1000000);
+BENCHMARK(Accounting_Select)->RangeMultiplier(100)->Range(100, 1000000);
+BENCHMARK(Accounting_Distinct)->RangeMultiplier(100)->Range(100, 1000000);
+BENCHMARK(Accounting_ToMap)->RangeMultiplier(100)->Range(100, 1000000);
@@ -0,0 +1,120 @@
+#ifndef LINQ_PLUSPLUS_BENCHMARK_DATA_H
+#define LINQ_PLUSPLUS_BENCHMARK_DATA_H
+
+#include "benchmark/benchmark.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace Bench
+{
+    // A 64-byte element, large enough that copying it dominates over moving an int.
+    struct Record
+    {
+        int64_t key;
+        double payload[7];
+    };
+
+    static_assert(sizeof(Record) == 64, "Record is meant to be 64 bytes");
+
+    inline bool operator<(const Record& lhs, const Record& rhs) { return lhs.key < rhs.key; }
+    inline bool operator==(const Record& lhs, const Record& rhs) { return lhs.key == rhs.key; }
+
+    // Scrambles the index so values are spread out but repeat often enough for distinct/except to have work to do.
+    inline int64_t scramble(size_t i)
+    {
+        return static_cast<int64_t>((i * 2654435761u) % 1000003);
+    }
+
+    // How each element type is generated and reduced. MaxSize keeps the largest inputs within a few GB of memory,
+    // given that Enumerable::from keeps its own copy of the source.
+    template <typename T> struct Element;
+
+    template <> struct Element<int>
+    {
+        typedef double CastTo;
+        static const int64_t MaxSize = 100000000;
+        static int make(size_t i) { return static_cast<int>(scramble(i)); }
+        static double value(const int& t) { return t; }
+        static int64_t key(const int& t) { return t; }
+    };
+
+    template <> struct Element<double>
+    {
+        typedef int CastTo;
+        static const int64_t MaxSize = 100000000;
+        static double make(size_t i) { return scramble(i) * 0.5; }
+        static double value(const double& t) { return t; }
+        static int64_t key(const double& t) { return static_cast<int64_t>(t); }
+    };
+
+    template <> struct Element<std::string>
+    {
+        typedef std::string CastTo;
+        static const int64_t MaxSize = 10000000;
+        static std::string make(size_t i) { return "element-" + std::to_string(scramble(i)); }
+        static double value(const std::string& t) { return static_cast<double>(t.size()); }
+        static int64_t key(const std::string& t) { return static_cast<int64_t>(t.size()) << 32 | static_cast<unsigned char>(t[t.size() - 1]); }
+    };
+
+    template <> struct Element<Record>
+    {
+        typedef Record CastTo;
+        static const int64_t MaxSize = 10000000;
+        static Record make(size_t i)
+        {
+            Record record = { scramble(i), { 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0 } };
+            record.payload[0] = static_cast<double>(i);
+            return record;
+        }
+        static double value(const Record& t) { return t.payload[0]; }
+        static int64_t key(const Record& t) { return t.key; }
+    };
+
+    template <typename T>
+    bool keep(const T& t)
+    {
+        return Element<T>::key(t) % 2 == 0;
+    }
+
+    template <typename T>
+    std::vector<T> make_data(int64_t size)
+    {
+        std::vector<T> data;
+        data.reserve(static_cast<size_t>(size));
+
+        for (int64_t i = 0; i < size; ++i)
+        {
+            data.push_back(Element<T>::make(static_cast<size_t>(i)));
+        }
+
+        return data;
+    }
+
+    // Sizes 10, 100, ... up to the element type's MaxSize.
+    template <typename T>
+    void sizes(benchmark::internal::Benchmark* benchmark)
+    {
+        for (int64_t size = 10; size <= Element<T>::MaxSize; size *= 10)
+        {
+            benchmark->Arg(size);
+        }
+    }
+
+    // Reports ns_per_element alongside the usual per-iteration time.
+    inline void set_counters(benchmark::State& state, int64_t elements)
+    {
+        state.SetItemsProcessed(state.iterations() * elements);
+        state.counters["ns_per_element"] = benchmark::Counter(
+            elements * 1e-9,
+            benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+    }
+}
+
+#define LINQ_BENCHMARK_ALL_TYPES(__benchmark) \
+    BENCHMARK_TEMPLATE(__benchmark, int)->Apply(Bench::sizes<int>); \
+    BENCHMARK_TEMPLATE(__benchmark, double)->Apply(Bench::sizes<double>); \
+    BENCHMARK_TEMPLATE(__benchmark, std::string)->Apply(Bench::sizes<std::string>); \
+    BENCHMARK_TEMPLATE(__benchmark, Bench::Record)->Apply(Bench::sizes<Bench::Record>)
+
+#endif
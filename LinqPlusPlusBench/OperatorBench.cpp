@@ -0,0 +1,1084 @@
+#include "BenchmarkData.h"
+#include "LinqPlusPlus/Enumerable.h"
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <random>
+#include <set>
+#include <thread>
+
+using namespace LinqPlusPlus;
+using namespace Bench;
+
+// Each operator is measured through LinqPlusPlus (Linq_*) and as the equivalent hand-written loop or std algorithm
+// (Loop_*), over the same generated data. Queries whose operators keep state between passes (distinct, except) are
+// rebuilt on every iteration; everything else is built once, outside the timed loop.
+
+namespace
+{
+    template <typename T>
+    double sum_values(const double& acc, const T& t)
+    {
+        return acc + Element<T>::value(t);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename T>
+void Linq_Where(benchmark::State& state)
+{
+    auto collection = Enumerable::from(make_data<T>(state.range(0)));
+    auto query = collection->where(&keep<T>);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(query->count());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+template <typename T>
+void Loop_Where(benchmark::State& state)
+{
+    auto source = make_data<T>(state.range(0));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(std::count_if(source.begin(), source.end(), &keep<T>));
+    }
+
+    set_counters(state, state.range(0));
+}
+
+LINQ_BENCHMARK_ALL_TYPES(Linq_Where);
+LINQ_BENCHMARK_ALL_TYPES(Loop_Where);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename T>
+void Linq_Cast(benchmark::State& state)
+{
+    typedef typename Element<T>::CastTo U;
+
+    auto collection = Enumerable::from(make_data<T>(state.range(0)));
+    auto query = collection->template cast<U>();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(query->template aggregate<double>(0.0, &sum_values<U>));
+    }
+
+    set_counters(state, state.range(0));
+}
+
+template <typename T>
+void Loop_Cast(benchmark::State& state)
+{
+    typedef typename Element<T>::CastTo U;
+
+    auto source = make_data<T>(state.range(0));
+
+    for (auto _ : state)
+    {
+        double sum = 0.0;
+        for (auto it = source.begin(); it != source.end(); ++it)
+        {
+            sum = sum_values<U>(sum, static_cast<U>(*it));
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    set_counters(state, state.range(0));
+}
+
+LINQ_BENCHMARK_ALL_TYPES(Linq_Cast);
+LINQ_BENCHMARK_ALL_TYPES(Loop_Cast);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename T>
+void Linq_Distinct(benchmark::State& state)
+{
+    auto collection = Enumerable::from(make_data<T>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(collection->distinct()->count());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+template <typename T>
+void Loop_Distinct(benchmark::State& state)
+{
+    auto source = make_data<T>(state.range(0));
+
+    for (auto _ : state)
+    {
+        std::set<T> distinct(source.begin(), source.end());
+        benchmark::DoNotOptimize(distinct.size());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+LINQ_BENCHMARK_ALL_TYPES(Linq_Distinct);
+LINQ_BENCHMARK_ALL_TYPES(Loop_Distinct);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename T>
+void Linq_Except(benchmark::State& state)
+{
+    auto source = make_data<T>(state.range(0));
+
+    std::vector<T> excludedValues;
+    std::copy_if(source.begin(), source.end(), std::back_inserter(excludedValues), &keep<T>);
+
+    auto collection = Enumerable::from(source);
+    auto excluded = Enumerable::from(excludedValues);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(collection->except(excluded)->count());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+template <typename T>
+void Loop_Except(benchmark::State& state)
+{
+    auto source = make_data<T>(state.range(0));
+
+    std::vector<T> excludedValues;
+    std::copy_if(source.begin(), source.end(), std::back_inserter(excludedValues), &keep<T>);
+
+    for (auto _ : state)
+    {
+        std::set<T> excluded(excludedValues.begin(), excludedValues.end());
+        benchmark::DoNotOptimize(std::count_if(source.begin(), source.end(), [&](const T& t)
+        {
+            return excluded.find(t) == excluded.end();
+        }));
+    }
+
+    set_counters(state, state.range(0));
+}
+
+LINQ_BENCHMARK_ALL_TYPES(Linq_Except);
+LINQ_BENCHMARK_ALL_TYPES(Loop_Except);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename T>
+void Linq_Concat(benchmark::State& state)
+{
+    auto source = make_data<T>(state.range(0));
+    auto middle = source.begin() + source.size() / 2;
+
+    auto first = Enumerable::from(std::vector<T>(source.begin(), middle));
+    auto second = Enumerable::from(std::vector<T>(middle, source.end()));
+    auto query = first->concat(second);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(query->template aggregate<double>(0.0, &sum_values<T>));
+    }
+
+    set_counters(state, state.range(0));
+}
+
+template <typename T>
+void Loop_Concat(benchmark::State& state)
+{
+    auto source = make_data<T>(state.range(0));
+    auto middle = source.begin() + source.size() / 2;
+
+    std::vector<T> first(source.begin(), middle);
+    std::vector<T> second(middle, source.end());
+
+    for (auto _ : state)
+    {
+        double sum = std::accumulate(first.begin(), first.end(), 0.0, &sum_values<T>);
+        benchmark::DoNotOptimize(std::accumulate(second.begin(), second.end(), sum, &sum_values<T>));
+    }
+
+    set_counters(state, state.range(0));
+}
+
+LINQ_BENCHMARK_ALL_TYPES(Linq_Concat);
+LINQ_BENCHMARK_ALL_TYPES(Loop_Concat);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename T>
+void Linq_Aggregate(benchmark::State& state)
+{
+    auto collection = Enumerable::from(make_data<T>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(collection->template aggregate<double>(0.0, &sum_values<T>));
+    }
+
+    set_counters(state, state.range(0));
+}
+
+template <typename T>
+void Loop_Aggregate(benchmark::State& state)
+{
+    auto source = make_data<T>(state.range(0));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(std::accumulate(source.begin(), source.end(), 0.0, &sum_values<T>));
+    }
+
+    set_counters(state, state.range(0));
+}
+
+LINQ_BENCHMARK_ALL_TYPES(Linq_Aggregate);
+LINQ_BENCHMARK_ALL_TYPES(Loop_Aggregate);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename T>
+void Linq_Average(benchmark::State& state)
+{
+    auto collection = Enumerable::from(make_data<T>(state.range(0)));
+    std::function<double(const T&)> selector = &Element<T>::value;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(collection->average(selector));
+    }
+
+    set_counters(state, state.range(0));
+}
+
+template <typename T>
+void Loop_Average(benchmark::State& state)
+{
+    auto source = make_data<T>(state.range(0));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(std::accumulate(source.begin(), source.end(), 0.0, &sum_values<T>) / source.size());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+LINQ_BENCHMARK_ALL_TYPES(Linq_Average);
+LINQ_BENCHMARK_ALL_TYPES(Loop_Average);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename T>
+void Linq_ToMap(benchmark::State& state)
+{
+    auto collection = Enumerable::from(make_data<T>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(collection->template to_map<int64_t>(&Element<T>::key).size());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+template <typename T>
+void Loop_ToMap(benchmark::State& state)
+{
+    auto source = make_data<T>(state.range(0));
+
+    for (auto _ : state)
+    {
+        std::map<int64_t, T> map;
+        for (auto it = source.begin(); it != source.end(); ++it)
+        {
+            map.insert(std::make_pair(Element<T>::key(*it), *it));
+        }
+
+        benchmark::DoNotOptimize(map.size());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+LINQ_BENCHMARK_ALL_TYPES(Linq_ToMap);
+LINQ_BENCHMARK_ALL_TYPES(Loop_ToMap);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename T>
+void Linq_ElementAt(benchmark::State& state)
+{
+    auto collection = Enumerable::from(make_data<T>(state.range(0)));
+    size_t last = static_cast<size_t>(state.range(0) - 1);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(collection->element_at(last));
+    }
+
+    set_counters(state, state.range(0));
+}
+
+template <typename T>
+void Loop_ElementAt(benchmark::State& state)
+{
+    auto source = make_data<T>(state.range(0));
+    size_t last = static_cast<size_t>(state.range(0) - 1);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(&source.at(last));
+    }
+
+    set_counters(state, state.range(0));
+}
+
+LINQ_BENCHMARK_ALL_TYPES(Linq_ElementAt);
+LINQ_BENCHMARK_ALL_TYPES(Loop_ElementAt);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Lookups that miss, over collections small enough that the cost is the miss itself rather than the scan.
+void Linq_ElementAtOrDefault_miss(benchmark::State& state)
+{
+    auto collection = Enumerable::from(make_data<int>(state.range(0)));
+    size_t past = static_cast<size_t>(state.range(0));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(collection->element_at_or_default(past, -1));
+    }
+}
+
+void Linq_FirstOrDefault_miss(benchmark::State& state)
+{
+    auto collection = Enumerable::from(make_data<int>(state.range(0)));
+    std::function<bool(const int&)> never = [](const int& n){ return n < 0; };
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(collection->first_or_default(never, -1));
+    }
+}
+
+void Linq_TryFirst_miss(benchmark::State& state)
+{
+    auto collection = Enumerable::from(make_data<int>(state.range(0)));
+    std::function<bool(const int&)> never = [](const int& n){ return n < 0; };
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(collection->try_first(never).has_value());
+    }
+}
+
+void Linq_TrySingle_miss(benchmark::State& state)
+{
+    auto collection = Enumerable::from(make_data<int>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(collection->try_single().has_value());
+    }
+}
+
+BENCHMARK(Linq_ElementAtOrDefault_miss)->Arg(0)->Arg(8);
+BENCHMARK(Linq_FirstOrDefault_miss)->Arg(0)->Arg(8);
+BENCHMARK(Linq_TryFirst_miss)->Arg(0)->Arg(8);
+BENCHMARK(Linq_TrySingle_miss)->Arg(0)->Arg(8);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void Linq_Range(benchmark::State& state)
+{
+    auto range = Enumerable::range<int>(0, static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(range->template aggregate<int64_t>(0, [](const int64_t& acc, const int& n){ return acc + n; }));
+    }
+
+    set_counters(state, state.range(0));
+}
+
+void Linq_RangeSum(benchmark::State& state)
+{
+    auto range = Enumerable::range<int64_t>(0, static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(range->sum());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+void Linq_RangeIndexed(benchmark::State& state)
+{
+    auto range = Enumerable::range<int>(0, static_cast<size_t>(state.range(0)))->indexed();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(std::accumulate(range.begin(), range.end(), int64_t(0)));
+    }
+
+    set_counters(state, state.range(0));
+}
+
+void Loop_Range(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+
+    for (auto _ : state)
+    {
+        int64_t sum = 0;
+        for (int n = 0; n < count; ++n)
+        {
+            benchmark::DoNotOptimize(sum += n);
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    set_counters(state, state.range(0));
+}
+
+#if defined(__cpp_impl_coroutine)
+void Linq_FromGenerator(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+    auto range = Enumerable::from_generator<int>([count]() -> Coroutines::Generator<int>
+    {
+        for (int n = 0; n < count; ++n)
+        {
+            co_yield n;
+        }
+    });
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(range->template aggregate<int64_t>(0, [](const int64_t& acc, const int& n){ return acc + n; }));
+    }
+
+    set_counters(state, state.range(0));
+}
+
+BENCHMARK(Linq_FromGenerator)->Apply(sizes<int>);
+#endif
+
+BENCHMARK(Linq_Range)->Apply(sizes<int>);
+BENCHMARK(Linq_RangeSum)->Apply(sizes<int>);
+BENCHMARK(Linq_RangeIndexed)->Apply(sizes<int>);
+BENCHMARK(Loop_Range)->Apply(sizes<int>);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace
+{
+    // Stands in for a stage that parses or decompresses records: roughly 100ns of work per element.
+    int64_t expensive(const int& n)
+    {
+        uint64_t x = static_cast<uint64_t>(n) + 1;
+        for (int i = 0; i < 64; ++i)
+        {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+        }
+
+        return static_cast<int64_t>(x >> 1);
+    }
+
+    bool checksum_ok(const int64_t& n)
+    {
+        return expensive(static_cast<int>(n)) % 2 == 0;
+    }
+}
+
+void Linq_Pipelined(benchmark::State& state)
+{
+    auto query = Enumerable::range<int>(0, static_cast<size_t>(state.range(0)))
+        ->select<int64_t>(&expensive)
+        ->where(&checksum_ok);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(query->count());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+void Linq_Pipelined_async_boundary(benchmark::State& state)
+{
+    auto query = Enumerable::range<int>(0, static_cast<size_t>(state.range(0)))
+        ->select<int64_t>(&expensive)
+        ->async_boundary()
+        ->where(&checksum_ok);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(query->count());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+BENCHMARK(Linq_Pipelined)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20)->UseRealTime();
+BENCHMARK(Linq_Pipelined_async_boundary)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20)->UseRealTime();
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void Linq_FromQueue(benchmark::State& state)
+{
+    const int count = static_cast<int>(state.range(0));
+
+    for (auto _ : state)
+    {
+        auto queue = std::make_shared<Concurrency::BoundedQueue<int> >(1024);
+        std::thread producer([=]()
+        {
+            for (int n = 0; n < count; ++n)
+            {
+                queue->push(n);
+            }
+
+            queue->close();
+        });
+
+        benchmark::DoNotOptimize(Enumerable::from_queue(queue)->where(&keep<int>)->count());
+        producer.join();
+    }
+
+    set_counters(state, state.range(0));
+}
+
+BENCHMARK(Linq_FromQueue)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20)->UseRealTime();
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Full reductions run on the push path; the Pull variants drive the same query through move_next/current_ref.
+namespace
+{
+    ENUMERABLE_PTR(int64_t) push_pull_query(int64_t size)
+    {
+        return Enumerable::from(make_data<int>(size))
+            ->where(&keep<int>)
+            ->select<int64_t>([](const int& n){ return static_cast<int64_t>(n) * 3; })
+            ->where([](const int64_t& n){ return n % 5 != 0; });
+    }
+
+    int64_t add(const int64_t& acc, const int64_t& n)
+    {
+        return acc + n;
+    }
+}
+
+void Linq_Push(benchmark::State& state)
+{
+    auto query = push_pull_query(state.range(0));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(query->aggregate<int64_t>(0, &add));
+    }
+
+    set_counters(state, state.range(0));
+}
+
+void Linq_Pull(benchmark::State& state)
+{
+    auto query = push_pull_query(state.range(0));
+
+    for (auto _ : state)
+    {
+        auto e = query->enumerator();
+        int64_t sum = 0;
+        while (e->move_next())
+        {
+            sum = add(sum, e->current_ref());
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    set_counters(state, state.range(0));
+}
+
+void Linq_Push_count(benchmark::State& state)
+{
+    auto query = Enumerable::range<int>(0, static_cast<size_t>(state.range(0)))->where(&keep<int>)->skip(1);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(query->count());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+void Linq_Pull_count(benchmark::State& state)
+{
+    auto query = Enumerable::range<int>(0, static_cast<size_t>(state.range(0)))->where(&keep<int>)->skip(1);
+
+    for (auto _ : state)
+    {
+        auto e = query->enumerator();
+        size_t count = 0;
+        while (e->move_next())
+        {
+            ++count;
+        }
+
+        benchmark::DoNotOptimize(count);
+    }
+
+    set_counters(state, state.range(0));
+}
+
+BENCHMARK(Linq_Push)->Apply(sizes<int>);
+BENCHMARK(Linq_Pull)->Apply(sizes<int>);
+BENCHMARK(Linq_Push_count)->Apply(sizes<int>);
+BENCHMARK(Linq_Pull_count)->Apply(sizes<int>);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Repeated reductions over the same query, replayed from a memoized recording against being run again each time.
+void Linq_Rerun(benchmark::State& state)
+{
+    auto query = push_pull_query(state.range(0));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(query->aggregate<int64_t>(0, &add));
+    }
+
+    set_counters(state, state.range(0));
+}
+
+void Linq_Memoized(benchmark::State& state)
+{
+    auto query = push_pull_query(state.range(0))->memoize();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(query->aggregate<int64_t>(0, &add));
+    }
+
+    set_counters(state, state.range(0));
+}
+
+BENCHMARK(Linq_Rerun)->Apply(sizes<int>);
+BENCHMARK(Linq_Memoized)->Apply(sizes<int>);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Re-evaluating a sum after appending 1024 elements to a vector of the given size: rescanning the whole vector against
+// an incremental aggregate that folds in just the new elements.
+void Linq_Rescan_after_append(benchmark::State& state)
+{
+    std::shared_ptr<std::vector<int> > data(new std::vector<int>(make_data<int>(state.range(0))));
+    auto query = Enumerable::from_append_only(data)->where(&keep<int>);
+
+    for (auto _ : state)
+    {
+        data->insert(data->end(), 1024, 1);
+        benchmark::DoNotOptimize(query->sum());
+    }
+}
+
+void Linq_Incremental_after_append(benchmark::State& state)
+{
+    std::shared_ptr<std::vector<int> > data(new std::vector<int>(make_data<int>(state.range(0))));
+    auto sum = Enumerable::from_append_only(data)->where(&keep<int>)->incremental_aggregate<int64_t>(0,
+        [](const int64_t& acc, const int& n){ return acc + n; });
+    sum.value();
+
+    for (auto _ : state)
+    {
+        data->insert(data->end(), 1024, 1);
+        benchmark::DoNotOptimize(sum.value());
+    }
+}
+
+BENCHMARK(Linq_Rescan_after_append)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(Linq_Incremental_after_append)->Arg(1 << 16)->Arg(1 << 20);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Rolling sums and maxima over windows of 256 elements, against summing each window's elements afresh.
+void Linq_Window_resum(benchmark::State& state)
+{
+    auto query = Enumerable::from(make_data<int>(state.range(0)))->window(256)->select<int64_t>([](const std::vector<int>& w)
+    {
+        return std::accumulate(w.begin(), w.end(), int64_t(0));
+    });
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(query->count());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+void Linq_WindowSum(benchmark::State& state)
+{
+    auto query = Enumerable::from(make_data<int>(state.range(0)))->window_sum(256);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(query->count());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+void Linq_WindowMax(benchmark::State& state)
+{
+    auto query = Enumerable::from(make_data<int>(state.range(0)))->window_max(256);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(query->count());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+BENCHMARK(Linq_Window_resum)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(Linq_WindowSum)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(Linq_WindowMax)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Approximate distinct counts and medians from sketches, against the exact answers.
+void Linq_DistinctCount(benchmark::State& state)
+{
+    auto query = Enumerable::from(make_data<int>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(query->distinct()->count());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+void Linq_ApproxCountDistinct(benchmark::State& state)
+{
+    auto query = Enumerable::from(make_data<int>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(query->approx_count_distinct());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+void Linq_Median_sorted(benchmark::State& state)
+{
+    auto query = Enumerable::from(make_data<int>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        std::vector<int> values = query->to_vector();
+        std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+        benchmark::DoNotOptimize(values[values.size() / 2]);
+    }
+
+    set_counters(state, state.range(0));
+}
+
+void Linq_ApproxPercentile(benchmark::State& state)
+{
+    auto query = Enumerable::from(make_data<int>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(query->approx_percentile(50));
+    }
+
+    set_counters(state, state.range(0));
+}
+
+BENCHMARK(Linq_DistinctCount)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(Linq_ApproxCountDistinct)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(Linq_Median_sorted)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(Linq_ApproxPercentile)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 1% samples: a coin flip per element in a where clause, against sample_fraction seeking from one kept element to the
+// next, and a 1024 element reservoir sample.
+void Linq_SampleFraction_where(benchmark::State& state)
+{
+    auto query = Enumerable::from(make_data<int>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        std::mt19937 random(0);
+        std::bernoulli_distribution coin(0.01);
+        benchmark::DoNotOptimize(query->where([&](const int&){ return coin(random); })->sum());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+void Linq_SampleFraction(benchmark::State& state)
+{
+    auto query = Enumerable::from(make_data<int>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(query->sample_fraction(0.01)->sum());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+void Linq_Sample(benchmark::State& state)
+{
+    auto query = Enumerable::from(make_data<int>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(query->sample(1024)->sum());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+BENCHMARK(Linq_SampleFraction_where)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(Linq_SampleFraction)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(Linq_Sample)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Count, sum, min, max and average of the same data: five terminals, each its own pass, against stats() folding
+// them all in one.
+void Linq_Stats_separate(benchmark::State& state)
+{
+    auto query = Enumerable::from(make_data<int>(state.range(0)));
+    std::function<int(const int&, const int&)> min = [](const int& x, const int& y){ return y < x ? y : x; };
+    std::function<int(const int&, const int&)> max = [](const int& x, const int& y){ return x < y ? y : x; };
+    std::function<int64_t(const int&)> value = [](const int& n){ return static_cast<int64_t>(n); };
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(query->count());
+        benchmark::DoNotOptimize(query->sum());
+        benchmark::DoNotOptimize(query->aggregate(min));
+        benchmark::DoNotOptimize(query->aggregate(max));
+        benchmark::DoNotOptimize(query->average(value));
+    }
+
+    set_counters(state, state.range(0));
+}
+
+void Linq_Stats(benchmark::State& state)
+{
+    auto query = Enumerable::from(make_data<int>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(query->stats());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+BENCHMARK(Linq_Stats_separate)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(Linq_Stats)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Point lookups against the same data: a where clause scanning it each time, against a hash index built once.
+void Linq_Lookup_where(benchmark::State& state)
+{
+    std::vector<int> data = make_data<int>(state.range(0));
+    auto query = Enumerable::from(data);
+    int key = data[data.size() / 2];
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(query->where([=](const int& n){ return n == key; })->count());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+void Linq_Lookup_index(benchmark::State& state)
+{
+    std::vector<int> data = make_data<int>(state.range(0));
+    auto index = Enumerable::from(data)->build_index<int>([](const int& n){ return n; });
+    int key = data[data.size() / 2];
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(index->lookup(key)->count());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+BENCHMARK(Linq_Lookup_where)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(Linq_Lookup_index)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Building a map of the data keyed on itself, and grouping it by its last two digits.
+void Linq_ToMap(benchmark::State& state)
+{
+    auto query = Enumerable::from(make_data<int>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(query->to_map<int>([](const int& n){ return n; }).size());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+void Linq_ToUnorderedMap(benchmark::State& state)
+{
+    auto query = Enumerable::from(make_data<int>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(query->to_unordered_map<int>([](const int& n){ return n; }).size());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+void Linq_ToFlatMap(benchmark::State& state)
+{
+    auto query = Enumerable::from(make_data<int>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(query->to_flat_map<int>([](const int& n){ return n; }).size());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+void Linq_GroupBy(benchmark::State& state)
+{
+    auto query = Enumerable::from(make_data<int>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(query->group_by<int>([](const int& n){ return n % 100; })->count());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+void Linq_ToLookup(benchmark::State& state)
+{
+    auto query = Enumerable::from(make_data<int>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(query->to_lookup<int>([](const int& n){ return n % 100; }).size());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+BENCHMARK(Linq_ToMap)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(Linq_ToUnorderedMap)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(Linq_ToFlatMap)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(Linq_GroupBy)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(Linq_ToLookup)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Distinct values and counts per value of strings with 100 distinct values, compared and hashed as strings against
+// dictionary encoded once and worked on as codes.
+namespace
+{
+    std::vector<std::string> make_categories(int64_t size)
+    {
+        std::vector<std::string> categories;
+        for (int64_t i = 0; i < size; ++i)
+        {
+            categories.push_back("category-" + std::to_string((i * 7919) % 100));
+        }
+        return categories;
+    }
+}
+
+void Linq_StringDistinct(benchmark::State& state)
+{
+    auto query = Enumerable::from(make_categories(state.range(0)));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(query->distinct()->count());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+void Linq_StringDistinct_encoded(benchmark::State& state)
+{
+    auto column = Enumerable::from(make_categories(state.range(0)))->dictionary_encode();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(column->distinct()->count());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+void Linq_StringCounts(benchmark::State& state)
+{
+    auto query = Enumerable::from(make_categories(state.range(0)));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(query->group_by<std::string>([](const std::string& s){ return s; })->count());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+void Linq_StringCounts_encoded(benchmark::State& state)
+{
+    auto column = Enumerable::from(make_categories(state.range(0)))->dictionary_encode();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(column->count_by().size());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+BENCHMARK(Linq_StringDistinct)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(Linq_StringDistinct_encoded)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(Linq_StringCounts)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(Linq_StringCounts_encoded)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// order_by within a memory budget of a quarter of the data, against sorting it all in memory.
+void Linq_OrderBy(benchmark::State& state)
+{
+    auto query = Enumerable::from(make_data<int>(state.range(0)))->order_by<int>([](const int& n){ return n; });
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(query->count());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+void Linq_OrderBy_spilled(benchmark::State& state)
+{
+    size_t budget = static_cast<size_t>(state.range(0)) * sizeof(int) * 2 / 4;
+    auto query = Enumerable::from(make_data<int>(state.range(0)))->order_by<int>([](const int& n){ return n; }, budget);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(query->count());
+    }
+
+    set_counters(state, state.range(0));
+}
+
+BENCHMARK(Linq_OrderBy)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(Linq_OrderBy_spilled)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
@@ -0,0 +1,228 @@
+#include "LinqPlusPlus/Enumerable.h"
+#include "LinqPlusPlus/Diagnostics/Accounting.h"
+#include "gtest/gtest.h"
+#include <functional>
+#include <vector>
+
+#ifndef LINQ_PLUSPLUS_INSTRUMENTATION
+#include "LinqPlusPlus/Diagnostics/CountingAllocator.h"
+#endif
+
+using namespace LinqPlusPlus;
+using namespace LinqPlusPlus::Diagnostics;
+using namespace testing;
+
+// Each operator declares how many allocations and element copies it may make per element. Costs are measured as
+// the difference between running the same query over N and 2N elements, so fixed per-query costs don't count
+// against the per-element budget. Query construction happens in prepare, before measuring starts, unless the
+// operator being budgeted is the construction itself.
+
+namespace
+{
+    typedef std::function<std::function<void()> (const std::vector<Tracked>&)> Prepare;
+
+    struct Cost
+    {
+        double allocations;
+        double copies;
+    };
+
+    Usage run(const Prepare& prepare, size_t size)
+    {
+        std::vector<Tracked> source;
+        for (size_t i = 0; i < size; ++i)
+        {
+            source.push_back(Tracked(static_cast<int>(i)));
+        }
+
+        std::function<void()> terminal = prepare(source);
+
+        Usage before = Usage::now();
+        terminal();
+        return Usage::now() - before;
+    }
+
+    Cost per_element(const Prepare& prepare)
+    {
+        const size_t size = 1000;
+
+        Usage once = run(prepare, size);
+        Usage twice = run(prepare, size * 2);
+
+        Cost cost = {
+            (static_cast<double>(twice.allocations) - once.allocations) / size,
+            (static_cast<double>(twice.copies) - once.copies) / size
+        };
+
+        return cost;
+    }
+
+    bool is_even(const Tracked& t)
+    {
+        return t.value() % 2 == 0;
+    }
+}
+
+#define ACCOUNTING_BUDGET(__subject, __allocations, __copies) \
+    static Cost __subject ## _cost(); \
+    TEST(AccountingBudget, __subject) \
+    { \
+        Cost cost = __subject ## _cost(); \
+        EXPECT_LE(cost.allocations, __allocations) << "allocations per element"; \
+        EXPECT_LE(cost.copies, __copies) << "copies per element"; \
+    } \
+    static Cost __subject ## _cost()
+
+ACCOUNTING_BUDGET(From_vector, 0, 1)
+{
+    return per_element([](const std::vector<Tracked>& source)
+    {
+        return [&]() { Enumerable::from(source); };
+    });
+}
+
+ACCOUNTING_BUDGET(Where_count, 0, 0)
+{
+    return per_element([](const std::vector<Tracked>& source) -> std::function<void()>
+    {
+        auto collection = Enumerable::from(source);
+        auto query = collection->where(&is_even)->where(&is_even);
+        return [collection, query]() { query->count(); };
+    });
+}
+
+// count() over a select or cast of a vector knows the size without projecting anything, so these pull every
+// element through current_ref instead, looking for one that isn't there.
+ACCOUNTING_BUDGET(Select_any, 0, 0)
+{
+    return per_element([](const std::vector<Tracked>& source) -> std::function<void()>
+    {
+        auto collection = Enumerable::from(source);
+        auto query = collection->select<int>([](const Tracked& t){ return t.value(); })
+            ->select<int>([](const int& n){ return n + 1; });
+        return [collection, query]() { query->any([](const int& n){ return n < 0; }); };
+    });
+}
+
+ACCOUNTING_BUDGET(Cast_any, 0, 1)
+{
+    return per_element([](const std::vector<Tracked>& source) -> std::function<void()>
+    {
+        auto collection = Enumerable::from(source);
+        auto query = collection->cast<Tracked>();
+        return [collection, query]() { query->any([](const Tracked& t){ return t.value() < 0; }); };
+    });
+}
+
+ACCOUNTING_BUDGET(Concat_count, 0, 0)
+{
+    return per_element([](const std::vector<Tracked>& source) -> std::function<void()>
+    {
+        auto first = Enumerable::from(source);
+        auto second = Enumerable::from(source);
+        auto query = first->concat(second);
+        return [first, second, query]() { query->count(); };
+    });
+}
+
+ACCOUNTING_BUDGET(Aggregate, 0, 0)
+{
+    return per_element([](const std::vector<Tracked>& source) -> std::function<void()>
+    {
+        auto collection = Enumerable::from(source);
+        return [collection]() { collection->aggregate<int>(0, [](const int& acc, const Tracked& t){ return acc + t.value(); }); };
+    });
+}
+
+ACCOUNTING_BUDGET(Average, 0, 0)
+{
+    return per_element([](const std::vector<Tracked>& source) -> std::function<void()>
+    {
+        auto collection = Enumerable::from(source);
+        std::function<double(const Tracked&)> selector = [](const Tracked& t){ return t.value(); };
+        return [collection, selector]() { collection->average(selector); };
+    });
+}
+
+ACCOUNTING_BUDGET(Distinct_count, 1, 2)
+{
+    return per_element([](const std::vector<Tracked>& source) -> std::function<void()>
+    {
+        auto collection = Enumerable::from(source);
+        return [collection]() { collection->distinct()->count(); };
+    });
+}
+
+ACCOUNTING_BUDGET(Except_count, 2, 4)
+{
+    return per_element([](const std::vector<Tracked>& source) -> std::function<void()>
+    {
+        auto collection = Enumerable::from(source);
+        auto excluded = collection->where(&is_even);
+        return [collection, excluded]() { collection->except(excluded)->count(); };
+    });
+}
+
+ACCOUNTING_BUDGET(ToMap, 1, 1)
+{
+    return per_element([](const std::vector<Tracked>& source) -> std::function<void()>
+    {
+        auto collection = Enumerable::from(source);
+        return [collection]() { collection->to_map<int>([](const Tracked& t){ return t.value(); }); };
+    });
+}
+
+ACCOUNTING_BUDGET(Consume_to_map, 1, 0)
+{
+    return per_element([](const std::vector<Tracked>& source) -> std::function<void()>
+    {
+        auto collection = Enumerable::from(std::vector<Tracked>(source));
+        return [collection]() { collection->consume()->to_map<int>([](const Tracked& t){ return t.value(); }); };
+    });
+}
+
+ACCOUNTING_BUDGET(ToVector, 0, 1)
+{
+    return per_element([](const std::vector<Tracked>& source) -> std::function<void()>
+    {
+        auto collection = Enumerable::from(source);
+        return [collection]() { collection->to_vector(); };
+    });
+}
+
+ACCOUNTING_BUDGET(Consume_to_vector, 0, 0)
+{
+    return per_element([](const std::vector<Tracked>& source) -> std::function<void()>
+    {
+        auto collection = Enumerable::from(std::vector<Tracked>(source));
+        return [collection]() { collection->consume()->to_vector(); };
+    });
+}
+
+ACCOUNTING_BUDGET(ElementAt, 0, 0)
+{
+    return per_element([](const std::vector<Tracked>& source) -> std::function<void()>
+    {
+        auto collection = Enumerable::from(source);
+        size_t last = source.size() - 1;
+        return [collection, last]() { collection->element_at(last); };
+    });
+}
+
+ACCOUNTING_BUDGET(FirstOrDefault_miss, 0, 0)
+{
+    return per_element([](const std::vector<Tracked>& source) -> std::function<void()>
+    {
+        auto collection = Enumerable::from(source);
+        return [collection]() { collection->first_or_default([](const Tracked& t){ return t.value() < 0; }, Tracked()); };
+    });
+}
+
+ACCOUNTING_BUDGET(Contains_miss, 0, 0)
+{
+    return per_element([](const std::vector<Tracked>& source) -> std::function<void()>
+    {
+        auto collection = Enumerable::from(source);
+        return [collection]() { collection->contains(Tracked(-1)); };
+    });
+}
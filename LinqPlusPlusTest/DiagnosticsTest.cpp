@@ -0,0 +1,133 @@
+#include "LinqPlusPlus/Enumerable.h"
+#include "LinqPlusPlus/Diagnostics/Trace.h"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace LinqPlusPlus;
+using namespace LinqPlusPlus::Diagnostics;
+using namespace testing;
+
+TEST(TraceTest, Writes_recorded_spans_as_chrome_trace_events)
+{
+    Trace::start();
+    {
+        TraceScope task("task", "parse \"records\"");
+    }
+    std::thread worker([]()
+    {
+        TraceScope batch("batch", "batch 0");
+    });
+    worker.join();
+    Trace::stop();
+
+    {
+        TraceScope ignored("task", "not recorded");
+    }
+
+    std::ostringstream out;
+    Trace::write(out);
+    std::string json = out.str();
+
+    EXPECT_EQ(0u, json.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["));
+    EXPECT_NE(std::string::npos, json.find("{\"name\":\"parse \\\"records\\\"\",\"cat\":\"task\",\"ph\":\"X\",\"pid\":1,\"tid\":0,\"ts\":"));
+    EXPECT_NE(std::string::npos, json.find("{\"name\":\"batch 0\",\"cat\":\"batch\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":"));
+    EXPECT_EQ(std::string::npos, json.find("not recorded"));
+}
+
+TEST(TraceTest, Records_async_boundary_workers)
+{
+    Trace::start();
+    Enumerable::range(0, 100)->async_boundary(8)->count();
+    Trace::stop();
+
+    std::ostringstream out;
+    Trace::write(out);
+
+    EXPECT_NE(std::string::npos, out.str().find("{\"name\":\"async_boundary\",\"cat\":\"worker\",\"ph\":\"X\""));
+}
+
+TEST(TraceTest, Keeps_only_the_most_recent_spans_once_a_thread_buffer_is_full)
+{
+    Trace::start(2);
+    {
+        TraceScope first("task", "first");
+    }
+    {
+        TraceScope second("task", "second");
+    }
+    {
+        TraceScope third("task", "third");
+    }
+    Trace::stop();
+
+    std::ostringstream out;
+    Trace::write(out);
+    std::string json = out.str();
+
+    EXPECT_EQ(std::string::npos, json.find("\"first\""));
+    EXPECT_LT(json.find("\"second\""), json.find("\"third\""));
+}
+
+TEST(TraceTest, Can_be_restarted_while_other_threads_are_recording)
+{
+    Trace::start(4);
+    std::atomic<bool> done(false);
+    std::atomic<int> spans(0);
+    std::thread worker([&]()
+    {
+        while (!done.load())
+        {
+            {
+                TraceScope span("task", "worker");
+            }
+            ++spans;
+        }
+    });
+
+    for (int i = 0; i < 100; ++i)
+    {
+        Trace::start(4 + i % 3);
+    }
+
+    for (int recorded = spans.load(); spans.load() < recorded + 2;)
+    {
+        std::this_thread::yield();
+    }
+
+    done.store(true);
+    worker.join();
+    Trace::stop();
+
+    {
+        TraceScope ignored("task", "not recorded");
+    }
+
+    std::ostringstream out;
+    Trace::write(out);
+
+    EXPECT_NE(std::string::npos, out.str().find("\"worker\""));
+    EXPECT_EQ(std::string::npos, out.str().find("not recorded"));
+}
+
+#ifdef LINQ_PLUSPLUS_INSTRUMENTATION
+TEST(TraceTest, Records_a_span_for_each_pass_over_an_operator)
+{
+    int values[] = { 1, 2, 3, 4 };
+    auto collection = Enumerable::from_array(values, 4);
+    auto query = collection->where([](const int& n){ return n > 1; });
+
+    Trace::start();
+    query->count();
+    Trace::stop();
+
+    std::ostringstream out;
+    Trace::write(out);
+    std::string json = out.str();
+
+    EXPECT_NE(std::string::npos, json.find("{\"name\":\"where\",\"cat\":\"operator\",\"ph\":\"X\""));
+    EXPECT_NE(std::string::npos, json.find("{\"name\":\"from_array\",\"cat\":\"operator\",\"ph\":\"X\""));
+}
+#endif
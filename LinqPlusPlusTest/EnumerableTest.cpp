@@ -1,27 +1,152 @@
 #include "LinqPlusPlus/Enumerable.h"
 #include "gtest/gtest.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <list>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <string>
+
+#if __cplusplus >= 201703L
+#include <execution>
+#endif
+
+#if __cplusplus > 201703L
+#include <ranges>
+#endif
 
 using namespace LinqPlusPlus;
 using namespace testing;
 
 #define ENUMERABLE_TEST(__subject, __test_name) TEST(EnumerableTest_ ## __subject, __test_name)
 
-ENUMERABLE_TEST(Iterators, Are_used_to_iterate_over_the_collection)
+namespace
+{
+    template <typename T>
+    std::vector<T> pulled(ENUMERABLE_PTR(T) query, size_t skipped)
+    {
+        auto e = query->enumerator();
+        for (size_t i = 0; i < skipped; ++i)
+            e->move_next();
+
+        std::vector<T> values;
+        while (e->move_next())
+            values.push_back(e->current());
+        return values;
+    }
+
+    template <typename T>
+    std::vector<T> pushed(ENUMERABLE_PTR(T) query, size_t skipped)
+    {
+        auto e = query->enumerator();
+        for (size_t i = 0; i < skipped; ++i)
+            e->move_next();
+
+        std::vector<T> values;
+        EXPECT_TRUE(e->push([&](T& t){ values.push_back(t); return true; }));
+        return values;
+    }
+}
+
+ENUMERABLE_TEST(Enumerator, Pushes_the_elements_move_next_would_reach)
+{
+    std::vector<int> values({ 5, 1, 4, 2, 3 });
+    int array[] = { 5, 1, 4, 2, 3 };
+    auto is_odd = [](const int& n){ return n % 2 != 0; };
+    auto doubled = [](const int& n){ return n * 2; };
+
+    std::vector<ENUMERABLE_PTR(int)> queries;
+    queries.push_back(Enumerable::from(values));
+    queries.push_back(Enumerable::from_array(array, 5));
+    queries.push_back(Enumerable::sequence(10, -3, 5));
+    queries.push_back(Enumerable::range(0, 8)->skip(3));
+    queries.push_back(Enumerable::from(values)->where(is_odd)->skip(1));
+    queries.push_back(Enumerable::from(values)->concat(Enumerable::range(0, 3)));
+    queries.push_back(Enumerable::from(values)->where(is_odd)->select<int>(doubled)->select<int>(doubled));
+    queries.push_back(Enumerable::range(0, 6)->select<int>(doubled));
+    queries.push_back(Enumerable::from(values)->distinct());
+
+    for (auto& query : queries)
+    {
+        for (size_t skipped = 0; skipped < 7; ++skipped)
+            EXPECT_EQ(pulled(query, skipped), pushed(query, skipped));
+    }
+}
+
+ENUMERABLE_TEST(Enumerator, Stops_pushing_when_the_sink_returns_false)
+{
+    std::vector<int> seen;
+    auto e = Enumerable::range(0, 10)->concat(Enumerable::range(10, 10))->enumerator();
+
+    EXPECT_FALSE(e->push([&](int& n){ seen.push_back(n); return n < 12; }));
+    EXPECT_EQ(static_cast<size_t>(13), seen.size());
+}
+
+ENUMERABLE_TEST(Enumerator, Gives_each_caller_an_independent_position)
+{
+    auto range = Enumerable::range(0, 3);
+    auto first = range->enumerator();
+    auto second = range->enumerator();
+
+    ASSERT_TRUE(first->move_next());
+    ASSERT_TRUE(first->move_next());
+    ASSERT_TRUE(second->move_next());
+    EXPECT_EQ(1, first->current());
+    EXPECT_EQ(0, second->current());
+
+    std::vector<int> pairs;
+    for (auto x : *range)
+        for (auto y : *range)
+            pairs.push_back(x * 10 + y);
+
+    EXPECT_EQ(static_cast<size_t>(9), pairs.size());
+    EXPECT_EQ(22, pairs.back());
+}
+
+ENUMERABLE_TEST(Enumerator, Lets_many_threads_enumerate_the_same_query)
 {
     std::vector<int> values;
-    values.push_back(25);
-    values.push_back(-25);
+    for (int i = 0; i < 10000; ++i)
+        values.push_back(i);
 
-    auto collection = Enumerable::from(values);
+    auto query = Enumerable::from(values)
+        ->where([](const int& n){ return n % 3 == 0; })
+        ->select<int64_t>([](const int& n){ return static_cast<int64_t>(n) * 2; })
+        ->distinct();
 
-    std::vector<int>::iterator expected = values.begin();
-    IEnumerable<int>::iterator actual = collection->begin();
+    const int64_t expected = query->sum();
 
-    EXPECT_EQ(*expected, *actual);
-    ++expected; ++actual;
-    EXPECT_EQ(*expected, *actual);
-    ++expected;  ++actual;
-    EXPECT_EQ(collection->end(), actual);
+    std::vector<int64_t> results(8);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < results.size(); ++t)
+    {
+        threads.push_back(std::thread([&, t]()
+        {
+            for (int i = 0; i < 20; ++i)
+                results[t] += query->sum() == expected ? 1 : 0;
+        }));
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    for (auto result : results)
+        EXPECT_EQ(20, result);
+}
+
+ENUMERABLE_TEST(Enumerator, Keeps_the_queries_it_reads_from_alive)
+{
+    std::vector<int> values({ 1, 2, 3, 4 });
+
+    auto squares = Enumerable::from(values)
+        ->where([](const int& n){ return n % 2 == 0; })
+        ->select<int>([](const int& n){ return n * n; });
+
+    EXPECT_EQ(std::vector<int>({ 4, 16 }), squares->to_vector());
 }
 
 ENUMERABLE_TEST(Range, Generates_a_sequence_of_integral_values)
@@ -30,6 +155,281 @@ ENUMERABLE_TEST(Range, Generates_a_sequence_of_integral_values)
     EXPECT_EQ(0, range->aggregate([](const int& x, const int& y){ return x + y; }));
 }
 
+ENUMERABLE_TEST(Range, Generates_a_sequence_from_runtime_bounds_of_any_arithmetic_type)
+{
+    int64_t start = 5000000000LL;
+    auto range = Enumerable::range(start, 4);
+
+    std::vector<int64_t> values;
+    for (auto n : *range)
+        values.push_back(n);
+
+    ASSERT_EQ(static_cast<size_t>(4), values.size());
+    EXPECT_EQ(start, values[0]);
+    EXPECT_EQ(start + 3, values[3]);
+    EXPECT_EQ(static_cast<size_t>(0), Enumerable::range(0, 0)->count());
+}
+
+ENUMERABLE_TEST(Range, Answers_count_element_at_and_sum_without_enumerating)
+{
+    auto range = Enumerable::range<uint64_t>(1, 1000000000);
+
+    EXPECT_EQ(static_cast<size_t>(1000000000), range->count());
+    EXPECT_EQ(static_cast<uint64_t>(123456790), range->element_at(123456789));
+    EXPECT_EQ(static_cast<uint64_t>(500000000500000000ULL), range->sum());
+    EXPECT_THROW(range->element_at(1000000000), std::out_of_range);
+}
+
+ENUMERABLE_TEST(Sequence, Computes_each_element_from_its_index)
+{
+    auto sequence = Enumerable::sequence(0.0, 0.1, 11);
+
+    EXPECT_EQ(static_cast<size_t>(11), sequence->count());
+    EXPECT_DOUBLE_EQ(1.0, sequence->element_at(10));
+    EXPECT_DOUBLE_EQ(5.5, sequence->sum());
+
+    auto descending = Enumerable::sequence(10, -3, 4);
+    std::vector<int> values;
+    for (auto n : *descending)
+        values.push_back(n);
+
+    EXPECT_EQ(std::vector<int>({ 10, 7, 4, 1 }), values);
+}
+
+#if defined(__cpp_impl_coroutine)
+namespace
+{
+    // Resumes the awaiting coroutine from a queue drained by the test, standing in for an event loop.
+    struct Yield
+    {
+        std::deque<std::coroutine_handle<> >* loop;
+
+        bool await_ready() { return false; }
+        void await_suspend(std::coroutine_handle<> handle) { loop->push_back(handle); }
+        void await_resume() {}
+    };
+
+    // Resumes the awaiting coroutine on a new thread, standing in for an I/O completion.
+    struct ResumeOnNewThread
+    {
+        std::vector<std::thread>* threads;
+
+        bool await_ready() { return false; }
+        void await_suspend(std::coroutine_handle<> handle) { threads->push_back(std::thread([handle](){ handle.resume(); })); }
+        void await_resume() {}
+    };
+
+    struct Task
+    {
+        struct promise_type
+        {
+            Task get_return_object() { return Task(); }
+            std::suspend_never initial_suspend() { return std::suspend_never(); }
+            std::suspend_never final_suspend() noexcept { return std::suspend_never(); }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+        };
+    };
+
+    Coroutines::AsyncGenerator<int> polled(std::deque<std::coroutine_handle<> >* loop, int count)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            co_await Yield{ loop };
+            co_yield i;
+        }
+    }
+
+    Task sum_of(Coroutines::AsyncGenerator<int> generator, int* sum, bool* done)
+    {
+        // Not co_awaited in the loop condition, which GCC 12 miscompiles.
+        for (;;)
+        {
+            bool more = co_await generator.move_next();
+            if (!more)
+                break;
+            *sum += generator.current_ref();
+        }
+        *done = true;
+    }
+}
+
+ENUMERABLE_TEST(FromGenerator, Enumerates_what_the_coroutine_yields)
+{
+    auto squares = Enumerable::from_generator<int>([]() -> Coroutines::Generator<int>
+    {
+        for (int i = 0; i < 6; ++i)
+            co_yield i * i;
+    });
+    auto evens = squares->where([](const int& n){ return n % 2 == 0; });
+
+    EXPECT_EQ(std::vector<int>({ 0, 4, 16 }), evens->to_vector());
+    EXPECT_EQ(std::vector<int>({ 0, 4, 16 }), evens->to_vector());
+
+    auto e = squares->enumerator();
+    ASSERT_TRUE(e->move_next());
+    ASSERT_TRUE(e->move_next());
+    EXPECT_EQ(1, e->current());
+    e->reset();
+    ASSERT_TRUE(e->move_next());
+    EXPECT_EQ(0, e->current());
+}
+
+ENUMERABLE_TEST(FromGenerator, Rethrows_errors_from_the_coroutine)
+{
+    auto failing = Enumerable::from_generator<int>([]() -> Coroutines::Generator<int>
+    {
+        co_yield 1;
+        throw std::runtime_error("bad record");
+    });
+
+    EXPECT_EQ(1, failing->first());
+    EXPECT_THROW(failing->count(), std::runtime_error);
+}
+
+ENUMERABLE_TEST(FromGenerator, Waits_for_asynchronous_coroutines)
+{
+    std::vector<std::thread> threads;
+    auto values = Enumerable::from_generator<int>([&]() -> Coroutines::AsyncGenerator<int>
+    {
+        for (int i = 1; i <= 3; ++i)
+        {
+            co_await ResumeOnNewThread{ &threads };
+            co_yield i;
+        }
+    });
+
+    EXPECT_EQ(std::vector<int>({ 1, 2, 3 }), values->to_vector());
+
+    for (auto& thread : threads)
+        thread.join();
+    EXPECT_EQ(static_cast<size_t>(3), threads.size());
+}
+
+ENUMERABLE_TEST(FromGenerator, Lets_coroutines_await_the_next_element_without_blocking)
+{
+    std::deque<std::coroutine_handle<> > loop;
+    int sum = 0;
+    bool done = false;
+
+    sum_of(polled(&loop, 4), &sum, &done);
+    EXPECT_FALSE(done);
+
+    while (!loop.empty())
+    {
+        auto handle = loop.front();
+        loop.pop_front();
+        handle.resume();
+    }
+
+    EXPECT_TRUE(done);
+    EXPECT_EQ(6, sum);
+}
+
+ENUMERABLE_TEST(FromGenerator, Reuses_coroutine_frames)
+{
+    void* frame = Coroutines::FrameArena::allocate(200);
+    Coroutines::FrameArena::deallocate(frame, 200);
+
+    void* next = Coroutines::FrameArena::allocate(210);
+    EXPECT_EQ(frame, next);
+    Coroutines::FrameArena::deallocate(next, 210);
+}
+#endif
+
+ENUMERABLE_TEST(Skip, Skips_the_given_number_of_elements)
+{
+    std::list<int> values({ 1, 2, 3, 4, 5 });
+    auto collection = Enumerable::from(values);
+    auto filtered = collection->where([](const int& n){ return n != 3; });
+    auto skipped = filtered->skip(2);
+
+    std::vector<int> actual;
+    for (auto n : *skipped)
+        actual.push_back(n);
+
+    EXPECT_EQ(std::vector<int>({ 4, 5 }), actual);
+    EXPECT_EQ(static_cast<size_t>(0), collection->skip(10)->count());
+}
+
+ENUMERABLE_TEST(Skip, Seeks_past_the_skipped_elements_of_a_random_access_source)
+{
+    auto range = Enumerable::range<uint64_t>(0, 1000000000);
+    auto skipped = range->skip(999999998);
+
+    EXPECT_EQ(static_cast<uint64_t>(999999999), skipped->element_at(1));
+    EXPECT_EQ(static_cast<size_t>(2), skipped->count());
+}
+
+ENUMERABLE_TEST(Adaptive, Reorders_fused_predicates_so_the_most_selective_runs_first)
+{
+    std::vector<int> values;
+    for (int i = 0; i < 1000; ++i)
+        values.push_back(i);
+
+    auto collection = Enumerable::from(values);
+    auto query = collection
+        ->where([](const int& n){ return n >= 0; })
+        ->where([](const int& n){ return n % 10 == 0; })
+        ->adaptive(100, 0);
+
+    auto enumerator = query->enumerator();
+    size_t count = 0;
+    while (enumerator->move_next())
+        ++count;
+
+    EXPECT_EQ(static_cast<size_t>(100), count);
+
+    auto& filter = dynamic_cast<Enumerators::Filter<int>&>(Enumerators::unwrap(*enumerator));
+    ASSERT_EQ(static_cast<size_t>(2), filter.statistics().size());
+    EXPECT_EQ(static_cast<size_t>(1), filter.statistics()[0].position);
+    EXPECT_EQ(static_cast<size_t>(100), filter.statistics()[0].evaluated);
+    EXPECT_DOUBLE_EQ(0.1, filter.statistics()[0].pass_rate());
+    EXPECT_DOUBLE_EQ(1.0, filter.statistics()[1].pass_rate());
+
+    enumerator->reset();
+    EXPECT_EQ(static_cast<size_t>(0), filter.statistics()[0].position);
+    EXPECT_EQ(static_cast<size_t>(0), filter.statistics()[0].evaluated);
+
+    count = 0;
+    while (enumerator->move_next())
+        ++count;
+
+    EXPECT_EQ(static_cast<size_t>(100), count);
+    EXPECT_EQ(static_cast<size_t>(1), filter.statistics()[0].position);
+    EXPECT_EQ(static_cast<size_t>(100), filter.statistics()[0].evaluated);
+}
+
+ENUMERABLE_TEST(Adaptive, Reports_the_statistics_each_time_it_reorders)
+{
+    std::vector<std::vector<Enumerators::PredicateStatistics> > reports;
+    auto query = Enumerable::range(0, 1000)
+        ->where([](const int& n){ return n >= 0; })
+        ->where([](const int& n){ return n % 10 == 0; })
+        ->adaptive(100, 500, [&](const std::vector<Enumerators::PredicateStatistics>& statistics)
+        {
+            reports.push_back(statistics);
+        });
+
+    EXPECT_EQ(100u, query->count());
+
+    ASSERT_EQ(2u, reports.size());
+    for (const std::vector<Enumerators::PredicateStatistics>& statistics : reports)
+    {
+        ASSERT_EQ(2u, statistics.size());
+        EXPECT_EQ(1u, statistics[0].position);
+        EXPECT_EQ(100u, statistics[0].evaluated);
+        EXPECT_DOUBLE_EQ(0.1, statistics[0].pass_rate());
+    }
+}
+
+ENUMERABLE_TEST(Adaptive, Errors_if_the_query_does_not_end_in_a_where_clause)
+{
+    auto collection = Enumerable::range<0, 10>();
+
+    EXPECT_THROW(collection->adaptive(), std::runtime_error);
+}
+
 ENUMERABLE_TEST(Aggregate, Aggregates_the_items_in_a_collection)
 {
     std::vector<int> values;
@@ -92,6 +492,66 @@ ENUMERABLE_TEST(Aggregate, Errors_if_the_collection_is_empty)
     EXPECT_THROW(collection->aggregate([](const int& xs, const int& x){ return xs + x; }), std::runtime_error);
 }
 
+ENUMERABLE_TEST(AggregateMany, Evaluates_several_accumulators_in_a_single_pass)
+{
+    std::vector<int> values;
+    for (int i = 0; i < 3000; ++i)
+        values.push_back((i * 7919) % 3001 - 1500);
+
+    int passes = 0;
+    auto collection = Enumerable::from(values);
+    auto query = collection->where([&](const int& n){ passes += n == values[0]; return true; });
+    auto aggregate = [](ENUMERABLE_PTR(int) source)
+    {
+        return source->aggregate_many(Aggregators::count(), Aggregators::sum(), Aggregators::min(), Aggregators::max(),
+            Aggregators::average([](const int& n){ return n * 2; }),
+            Aggregators::fold(0, [](int positives, const int& n){ return positives + (n > 0); }));
+    };
+
+    auto results = aggregate(query);
+    EXPECT_EQ(1, passes);
+    EXPECT_EQ(3000u, std::get<0>(results));
+    EXPECT_EQ(collection->sum(), std::get<1>(results));
+    EXPECT_EQ(*std::min_element(values.begin(), values.end()), *std::get<2>(results));
+    EXPECT_EQ(*std::max_element(values.begin(), values.end()), *std::get<3>(results));
+    EXPECT_DOUBLE_EQ(collection->average(std::function<double(const int&)>([](const int& n){ return n * 2.0; })), std::get<4>(results));
+    EXPECT_EQ(collection->count([](const int& n){ return n > 0; }), static_cast<size_t>(std::get<5>(results)));
+
+    for (auto source : { collection, collection->memoize() })
+    {
+        auto blocked = aggregate(source);
+        EXPECT_EQ(std::get<1>(results), std::get<1>(blocked));
+        EXPECT_EQ(*std::get<2>(results), *std::get<2>(blocked));
+        EXPECT_EQ(*std::get<3>(results), *std::get<3>(blocked));
+        EXPECT_EQ(std::get<5>(results), std::get<5>(blocked));
+    }
+
+    auto empty = Enumerable::from(std::vector<int>())->aggregate_many(Aggregators::count(), Aggregators::max());
+    EXPECT_EQ(0u, std::get<0>(empty));
+    EXPECT_FALSE(std::get<1>(empty).has_value());
+}
+
+ENUMERABLE_TEST(Stats, Computes_count_sum_min_max_and_average_together)
+{
+    double values[] = { 2.5, -1.0, 4.0, 0.5 };
+    auto collection = Enumerable::from_array(values, 4);
+
+    auto stats = collection->stats();
+    EXPECT_EQ(4u, stats.count);
+    EXPECT_DOUBLE_EQ(6.0, stats.sum);
+    EXPECT_DOUBLE_EQ(-1.0, stats.min);
+    EXPECT_DOUBLE_EQ(4.0, stats.max);
+    EXPECT_DOUBLE_EQ(1.5, stats.average);
+
+    auto lengths = Enumerable::from(std::vector<std::string>({ "a", "abc", "ab" }))->stats([](const std::string& s){ return s.size(); });
+    EXPECT_EQ(6u, lengths.sum);
+    EXPECT_EQ(1u, lengths.min);
+    EXPECT_EQ(3u, lengths.max);
+    EXPECT_DOUBLE_EQ(2.0, lengths.average);
+
+    EXPECT_THROW(Enumerable::from(std::vector<int>())->stats(), std::runtime_error);
+}
+
 ENUMERABLE_TEST(All, Determines_if_all_the_elements_of_a_collection_satisfy_the_given_predicate)
 {
     int values[] = { 2, 4, 6, 8, 10 };
@@ -105,6 +565,15 @@ ENUMERABLE_TEST(All, Determines_if_all_the_elements_of_a_collection_satisfy_the_
     EXPECT_FALSE(collection->all(is_greater_than_five));
 }
 
+ENUMERABLE_TEST(All, Stops_at_the_first_element_that_does_not_satisfy_the_predicate)
+{
+    int evaluated = 0;
+    auto collection = Enumerable::range(0, 100)->where([](const int& n){ return n % 2 == 0; });
+
+    EXPECT_FALSE(collection->all([&](const int& n){ ++evaluated; return n < 10; }));
+    EXPECT_EQ(6, evaluated);
+}
+
 ENUMERABLE_TEST(Any, Determines_if_the_collection_contains_any_elements)
 {
     std::deque<int> values;
@@ -128,6 +597,125 @@ ENUMERABLE_TEST(Any, Determines_if_the_collection_contains_any_elements_that_sat
     EXPECT_FALSE(collection->any([](const char& value){ return value == 'e'; }));
 }
 
+ENUMERABLE_TEST(ApproxCountDistinct, Estimates_the_number_of_distinct_elements)
+{
+    auto ids = Enumerable::range(0, 200000)->select<int>([](const int& n){ return n % 50000; });
+
+    EXPECT_NEAR(50000.0, static_cast<double>(ids->approx_count_distinct()), 50000 * 0.03);
+    EXPECT_EQ(10u, Enumerable::range(0, 1000)->select<int>([](const int& n){ return n % 10; })->approx_count_distinct());
+}
+
+ENUMERABLE_TEST(ApproxCountDistinct, Merges_sketches_of_chunks_built_in_parallel)
+{
+    auto words = Enumerable::range(0, 40000)->select<std::string>([](const int& n){ return "id" + std::to_string(n % 30000); });
+
+    std::vector<Sketches::HyperLogLog> sketches(4);
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < sketches.size(); ++i)
+    {
+        workers.push_back(std::thread([&, i]()
+        {
+            sketches[i] = Enumerable::range(static_cast<int>(i) * 10000, 10000)
+                ->select<std::string>([](const int& n){ return "id" + std::to_string(n % 30000); })
+                ->distinct_sketch();
+        }));
+    }
+
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+
+    for (size_t i = 1; i < sketches.size(); ++i)
+    {
+        sketches[0].merge(sketches[i]);
+    }
+
+    EXPECT_EQ(words->distinct_sketch().estimate(), sketches[0].estimate());
+    EXPECT_THROW(sketches[0].merge(Sketches::HyperLogLog(10)), std::runtime_error);
+}
+
+ENUMERABLE_TEST(ApproxQuantiles, Estimates_quantiles_within_the_rank_error_in_bounded_memory)
+{
+    auto values = Enumerable::range(0, 100000)->select<int>([](const int& n){ return static_cast<int>((n * 7919LL) % 100000); });
+
+    std::vector<int> quartiles = values->approx_quantiles({ 0.0, 0.25, 0.5, 0.75, 1.0 });
+    EXPECT_EQ(0, quartiles[0]);
+    EXPECT_NEAR(25000, quartiles[1], 1000);
+    EXPECT_NEAR(50000, quartiles[2], 1000);
+    EXPECT_NEAR(75000, quartiles[3], 1000);
+    EXPECT_EQ(99999, quartiles[4]);
+    EXPECT_NEAR(99000, values->approx_percentile(99), 1000);
+
+    auto sketch = values->quantile_sketch();
+    EXPECT_EQ(100000u, sketch.count());
+    EXPECT_LT(sketch.retained(), 1000u);
+    EXPECT_THROW(values->approx_percentile(101), std::out_of_range);
+}
+
+ENUMERABLE_TEST(ApproxQuantiles, Merges_sketches_of_chunks)
+{
+    Sketches::KllSketch<int> merged;
+    for (int chunk = 0; chunk < 10; ++chunk)
+    {
+        merged.merge(Enumerable::range(chunk * 10000, 10000)->quantile_sketch());
+    }
+
+    EXPECT_EQ(100000u, merged.count());
+    EXPECT_NEAR(90000, merged.quantile(0.9), 1000);
+    EXPECT_THROW(Sketches::KllSketch<int>().quantile(0.5), std::runtime_error);
+}
+
+ENUMERABLE_TEST(AsyncBoundary, Produces_the_same_elements_in_the_same_order)
+{
+    auto squares = Enumerable::range(0, 10000)
+        ->select<int64_t>([](const int& n){ return static_cast<int64_t>(n) * n; });
+    auto pipelined = squares->async_boundary(16)->where([](const int64_t& n){ return n % 3 == 0; });
+
+    EXPECT_EQ(squares->where([](const int64_t& n){ return n % 3 == 0; })->to_vector(), pipelined->to_vector());
+    EXPECT_EQ(squares->sum(), squares->async_boundary(16)->sum());
+    EXPECT_EQ(static_cast<size_t>(0), Enumerable::range(0, 0)->async_boundary()->count());
+}
+
+ENUMERABLE_TEST(AsyncBoundary, Runs_at_most_capacity_elements_ahead_of_the_consumer)
+{
+    std::atomic<int> produced(0);
+    auto query = Enumerable::range(0, 1000)
+        ->select<int>([&](const int& n){ ++produced; return n; })
+        ->async_boundary(4);
+
+    auto e = query->enumerator();
+    ASSERT_TRUE(e->move_next());
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    // The element handed out, a full ring, and the one the worker is waiting to push.
+    EXPECT_GE(6, produced.load());
+
+    e->reset();
+    produced = 0;
+    EXPECT_EQ(999 * 1000 / 2, query->sum());
+    EXPECT_EQ(1000, produced.load());
+}
+
+ENUMERABLE_TEST(AsyncBoundary, Stops_the_worker_when_the_consumer_stops_early)
+{
+    auto query = Enumerable::range<int64_t>(0, 1000000000)->select<int64_t>([](const int64_t& n){ return n; })->async_boundary(8);
+
+    EXPECT_EQ(0, query->first());
+    EXPECT_EQ(5, query->element_at(5));
+}
+
+ENUMERABLE_TEST(AsyncBoundary, Rethrows_errors_from_the_worker)
+{
+    auto query = Enumerable::range(0, 100)
+        ->select<int>([](const int& n) -> int { if (n == 50) throw std::runtime_error("bad record"); return n; })
+        ->async_boundary(8);
+
+    EXPECT_THROW(query->to_vector(), std::runtime_error);
+    EXPECT_EQ(49, query->first([](const int& n){ return n == 49; }));
+    EXPECT_THROW(Enumerable::range(0, 1)->async_boundary(0), std::runtime_error);
+}
+
 ENUMERABLE_TEST(Average, Averages_the_items_in_the_collection_using_the_given_selector)
 {
     std::vector<int> values;
@@ -162,6 +750,73 @@ ENUMERABLE_TEST(Cast, Casts_each_element_of_the_collection_to_the_given_type)
     });
 }
 
+ENUMERABLE_TEST(BuildIndex, Looks_up_equal_keys_and_ranges_of_keys_without_scanning)
+{
+    typedef std::vector<std::pair<int, std::string> > Rows;
+    Rows values({ { 3, "c" }, { 1, "a" }, { 2, "b" }, { 1, "d" }, { 5, "e" } });
+    auto index = Enumerable::from(values)
+        ->build_index<int>([](const std::pair<int, std::string>& p){ return p.first; });
+
+    EXPECT_EQ(values, index->to_vector());
+    EXPECT_EQ(Rows({ { 1, "a" }, { 1, "d" } }), index->lookup(1)->to_vector());
+    EXPECT_EQ(0u, index->lookup(4)->count());
+    EXPECT_EQ("d", index->lookup(1)->element_at(1).second);
+    EXPECT_TRUE(index->contains_key(5));
+    EXPECT_FALSE(index->contains_key(4));
+    EXPECT_TRUE(index->contains(std::make_pair(1, std::string("d"))));
+    EXPECT_FALSE(index->contains(std::make_pair(1, std::string("c"))));
+
+    auto range = index->range(1, 3);
+    EXPECT_EQ(Rows({ { 1, "a" }, { 1, "d" }, { 2, "b" } }), range->to_vector());
+    EXPECT_EQ("b", range->element_at(2).second);
+    EXPECT_EQ("c", index->range(3, 100)->first().second);
+    EXPECT_EQ(0u, index->range(6, 10)->count());
+}
+
+ENUMERABLE_TEST(BuildIndex, Uses_the_hash_index_for_contains_through_an_enumerable_pointer)
+{
+    int keys = 0;
+    ENUMERABLE_PTR(int) index = Enumerable::range(0, 100)->build_index<int>([&](const int& n){ ++keys; return n % 10; });
+
+    EXPECT_TRUE(index->contains(42));
+    EXPECT_FALSE(index->contains(100));
+    EXPECT_EQ(102, keys);
+}
+
+ENUMERABLE_TEST(BuildIndex, Only_needs_a_std_hash_for_the_key_when_looking_up_equal_keys)
+{
+    typedef std::pair<int, int> Point;
+    std::vector<Point> points({ { 2, 1 }, { 1, 5 }, { 1, 2 }, { 3, 0 } });
+    auto index = Enumerable::from(points)->build_index<Point>([](const Point& p){ return p; });
+
+    EXPECT_EQ(std::vector<Point>({ { 1, 2 }, { 1, 5 }, { 2, 1 } }), index->range(Point(1, 0), Point(3, 0))->to_vector());
+    EXPECT_TRUE(index->contains(Point(3, 0)));
+    EXPECT_FALSE(index->contains(Point(0, 3)));
+}
+
+ENUMERABLE_TEST(BuildIndex, Builds_each_index_once_when_threads_race_to_it)
+{
+    auto index = Enumerable::range(0, 100000)->build_index<int>([](const int& n){ return n % 1000; });
+
+    std::vector<std::thread> threads;
+    std::atomic<size_t> found(0);
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.push_back(std::thread([&, t]()
+        {
+            for (int key = t; key < 1000; key += 4)
+            {
+                found += index->lookup(key)->count();
+                found += index->range(key, key + 1)->count();
+            }
+        }));
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(200000u, found.load());
+}
+
 ENUMERABLE_TEST(Concat, Concats_two_sequences)
 {
     std::vector<char> h;
@@ -178,6 +833,80 @@ ENUMERABLE_TEST(Concat, Concats_two_sequences)
     EXPECT_EQ(std::string("Hello, world!"), result->aggregate<std::string>("", [](const std::string& str, const char c){ return str + c; }));
 }
 
+ENUMERABLE_TEST(Consume, Moves_move_only_elements_through_the_query)
+{
+    std::vector<std::unique_ptr<int> > values;
+    for (int i = 0; i < 6; ++i)
+        values.push_back(std::unique_ptr<int>(new int(i)));
+
+    auto collection = Enumerable::from(std::move(values));
+    auto odds = collection->where([](const std::unique_ptr<int>& p){ return *p % 2 == 1; });
+
+    EXPECT_EQ(static_cast<size_t>(3), odds->count());
+    EXPECT_THROW(odds->first(), std::runtime_error);
+
+    auto enumerator = odds->enumerator();
+    ASSERT_TRUE(enumerator->move_next());
+    EXPECT_EQ(1, *enumerator->current_ref());
+    EXPECT_THROW(enumerator->current(), std::runtime_error);
+
+    std::vector<std::unique_ptr<int> > result = odds->consume()->to_vector();
+    ASSERT_EQ(static_cast<size_t>(3), result.size());
+    EXPECT_EQ(1, *result[0]);
+    EXPECT_EQ(5, *result[2]);
+}
+
+ENUMERABLE_TEST(Consume, Moves_elements_into_the_materialized_container)
+{
+    std::vector<std::string> values(3, std::string(100, 'x'));
+
+    auto collection = Enumerable::from(std::vector<std::string>(values));
+    auto consumed = collection->consume();
+
+    std::list<std::string> result = consumed->to_list();
+    ASSERT_EQ(static_cast<size_t>(3), result.size());
+    EXPECT_EQ(values[0], result.front());
+}
+
+ENUMERABLE_TEST(Consume, Moves_the_element_a_terminal_returns)
+{
+    std::vector<std::unique_ptr<int> > values;
+    for (int i = 0; i < 6; ++i)
+        values.push_back(std::unique_ptr<int>(new int(i)));
+
+    auto collection = Enumerable::from(std::move(values));
+
+    EXPECT_EQ(1, *collection->where([](const std::unique_ptr<int>& p){ return *p % 2 == 1; })->consume()->first());
+    EXPECT_EQ(4, *collection->consume()->element_at(4));
+}
+
+ENUMERABLE_TEST(Consume, Moves_move_only_elements_across_an_async_boundary)
+{
+    std::vector<std::unique_ptr<int> > values;
+    for (int i = 0; i < 100; ++i)
+        values.push_back(std::unique_ptr<int>(new int(i)));
+
+    std::vector<std::unique_ptr<int> > result = Enumerable::from(std::move(values))->consume()->async_boundary(8)->consume()->to_vector();
+
+    ASSERT_EQ(static_cast<size_t>(100), result.size());
+    EXPECT_EQ(0, *result[0]);
+    EXPECT_EQ(99, *result[99]);
+}
+
+ENUMERABLE_TEST(Consume, Copies_elements_of_borrowed_and_shared_containers)
+{
+    std::vector<std::string> values(3, std::string(100, 'x'));
+    auto shared = std::make_shared<std::vector<std::string> >(values);
+
+    auto borrowed = Enumerable::from(values);
+    auto sharing = Enumerable::from<std::string>(shared);
+
+    EXPECT_EQ(values, borrowed->consume()->to_vector());
+    EXPECT_EQ(values, sharing->where([](const std::string& s){ return !s.empty(); })->consume()->to_vector());
+    EXPECT_EQ(values[0], borrowed->first());
+    EXPECT_EQ(values, *shared);
+}
+
 ENUMERABLE_TEST(Contains, Determines_if_a_collection_contains_a_given_value)
 {
     std::vector<int> source;
@@ -247,6 +976,85 @@ ENUMERABLE_TEST(DefaultIfEmpty, Returns_a_collection_with_a_single_element_of_th
     EXPECT_EQ(10, *results->begin());
 }
 
+ENUMERABLE_TEST(DefaultIfEmpty, Reads_a_source_that_cannot_be_rewound_only_once)
+{
+    auto queue = std::make_shared<Concurrency::BoundedQueue<int> >(4);
+    queue->push(1); queue->push(2); queue->push(3);
+    queue->close();
+
+    auto results = Enumerable::from_queue(queue)->default_if_empty(0);
+
+    EXPECT_FALSE(results->has_random_access());
+    EXPECT_EQ(std::vector<int>({ 1, 2, 3 }), results->to_vector());
+
+    auto closed = std::make_shared<Concurrency::BoundedQueue<int> >(4);
+    closed->close();
+    EXPECT_EQ(std::vector<int>({ 0 }), Enumerable::from_queue(closed)->default_if_empty(0)->to_vector());
+}
+
+ENUMERABLE_TEST(DictionaryEncode, Stores_each_distinct_value_once_and_decodes_on_enumeration)
+{
+    std::vector<std::string> values({ "red", "green", "red", "blue", "green", "red" });
+    auto column = Enumerable::from(values)->dictionary_encode();
+
+    EXPECT_EQ(std::vector<std::string>({ "red", "green", "blue" }), column->dictionary());
+    EXPECT_EQ(std::vector<uint32_t>({ 0, 1, 0, 2, 1, 0 }), column->codes()->to_vector());
+    EXPECT_EQ(values, column->to_vector());
+    EXPECT_EQ("blue", column->element_at(3));
+    EXPECT_EQ(2u, *column->code_of("blue"));
+    EXPECT_FALSE(column->code_of("pink").has_value());
+
+    EXPECT_EQ(std::vector<std::string>({ "red", "green", "blue" }), column->distinct()->to_vector());
+    EXPECT_TRUE(column->distinct()->has_random_access());
+    EXPECT_EQ(3u, column->distinct()->count());
+    EXPECT_EQ("blue", column->distinct()->element_at(2));
+
+    FlatMap<std::string, size_t> counts = column->count_by();
+    EXPECT_EQ(3u, counts.at("red"));
+    EXPECT_EQ(1u, counts.at("blue"));
+    EXPECT_EQ("red", counts.begin()->first);
+
+    auto decoded = Enumerable::from_dictionary<std::string>({ "x", "y" }, { 1, 1, 0 });
+    EXPECT_EQ(std::vector<std::string>({ "y", "x" }), decoded->distinct()->to_vector());
+    EXPECT_THROW(Enumerable::from_dictionary<std::string>({ "x" }, { 1 }), std::out_of_range);
+    EXPECT_THROW(Enumerable::from_dictionary<std::string>({ "x", "x" }, { 0 }), std::runtime_error);
+}
+
+ENUMERABLE_TEST(DictionaryEncode, Finds_distinct_values_and_contains_on_the_codes_through_the_base_class)
+{
+    auto colors = Enumerable::from(std::vector<std::string>({ "red", "green", "red", "blue" }))->dictionary_encode();
+    ENUMERABLE_PTR(std::string) column = colors;
+    ENUMERABLE_PTR(std::string) reds = colors->where_equal("red");
+
+    auto distinct = column->distinct();
+    EXPECT_TRUE(distinct->has_random_access());
+    EXPECT_EQ(std::vector<std::string>({ "red", "green", "blue" }), distinct->to_vector());
+
+    EXPECT_TRUE(column->contains("blue"));
+    EXPECT_FALSE(column->contains("pink"));
+    EXPECT_TRUE(reds->contains("red"));
+    EXPECT_FALSE(reds->contains("blue"));
+}
+
+ENUMERABLE_TEST(DictionaryEncode, Groups_filters_and_joins_on_the_codes)
+{
+    auto colors = Enumerable::from(std::vector<std::string>({ "red", "green", "red", "blue" }))->dictionary_encode();
+
+    Lookup<std::string, size_t> groups = colors->group_positions();
+    EXPECT_EQ(3u, groups.size());
+    EXPECT_EQ("red", groups.key(0));
+    EXPECT_EQ(std::vector<size_t>({ 0, 2 }), std::vector<size_t>(groups["red"].begin(), groups["red"].end()));
+
+    EXPECT_EQ(std::vector<size_t>({ 0, 2 }), colors->positions_of("red"));
+    EXPECT_TRUE(colors->positions_of("pink").empty());
+    EXPECT_EQ(std::vector<std::string>({ "red", "red" }), colors->where_equal("red")->to_vector());
+    EXPECT_EQ(0u, colors->where_equal("pink")->count());
+
+    auto palette = Enumerable::from(std::vector<std::string>({ "blue", "red", "pink", "red" }))->dictionary_encode();
+    std::vector<std::pair<size_t, size_t> > expected({ { 0, 1 }, { 0, 3 }, { 2, 1 }, { 2, 3 }, { 3, 0 } });
+    EXPECT_EQ(expected, colors->join(*palette));
+}
+
 ENUMERABLE_TEST(Distinct, Returns_a_distinct_list_of_elements_using_the_equality_operator)
 {
     std::vector<char> letters;
@@ -344,12 +1152,60 @@ ENUMERABLE_TEST(Except, Returns_the_elements_not_in_the_collection_of_items_to_b
     EXPECT_EQ(std::string("aeiou"), result);
 }
 
-ENUMERABLE_TEST(First, Returns_the_first_element_of_a_collection)
+ENUMERABLE_TEST(Except, Can_exclude_elements_of_a_query_over_the_same_source)
 {
-    bool elements[] = { true, true, false, false };
-    auto collection = Enumerable::from_array(elements, sizeof(elements));
+    auto range = Enumerable::range(0, 10);
+    auto odds = range->where([](const int& n){ return n % 2 == 1; });
 
-    EXPECT_TRUE(collection->first());
+    auto evens = range->except(odds, [](const int& x, const int& y){ return x == y; });
+
+    EXPECT_EQ(std::vector<int>({ 0, 2, 4, 6, 8 }), evens->to_vector());
+}
+
+ENUMERABLE_TEST(Explain, Reports_statistics_for_each_operator_in_the_query)
+{
+    std::vector<int> values;
+    for (int i = 0; i < 100; ++i)
+        values.push_back(i);
+
+    auto collection = Enumerable::from(values);
+
+#ifdef LINQ_PLUSPLUS_INSTRUMENTATION
+    auto query = collection
+        ->where([](const int& n){ return n % 2 == 0; })
+        ->where([](const int& n){ return n < 50; })
+        ->select<int>([](const int& n){ return n * 2; });
+
+    EXPECT_EQ(static_cast<size_t>(25), query->count());
+
+    std::vector<std::string> names;
+    std::vector<uint64_t> elementsIn;
+    std::vector<uint64_t> elementsOut;
+    query->explain([&](const Diagnostics::OperatorStatistics& statistics, size_t depth)
+    {
+        names.push_back(std::string(depth, '>') + statistics.name());
+        elementsIn.push_back(statistics.elements_in());
+        elementsOut.push_back(statistics.elements_out());
+    });
+
+    ASSERT_EQ(static_cast<size_t>(2), names.size());
+    EXPECT_EQ(std::string("where+where+select"), names[0]);
+    EXPECT_EQ(std::string(">from"), names[1]);
+    EXPECT_EQ(static_cast<uint64_t>(100), elementsIn[0]);
+    EXPECT_EQ(static_cast<uint64_t>(25), elementsOut[0]);
+    EXPECT_EQ(static_cast<uint64_t>(100), elementsOut[1]);
+    EXPECT_EQ(0u, query->explain().find("where+where+select (in=100 out=25 move_next=26 "));
+#else
+    EXPECT_NE(std::string::npos, collection->explain().find("LINQ_PLUSPLUS_INSTRUMENTATION"));
+#endif
+}
+
+ENUMERABLE_TEST(First, Returns_the_first_element_of_a_collection)
+{
+    bool elements[] = { true, true, false, false };
+    auto collection = Enumerable::from_array(elements, sizeof(elements));
+
+    EXPECT_TRUE(collection->first());
 }
 
 ENUMERABLE_TEST(First, Returns_the_first_element_of_a_collection_that_satifies_the_given_predicate)
@@ -401,3 +1257,792 @@ ENUMERABLE_TEST(FirstOrDefault, Returns_the_default_value_if_no_element_satisfie
     auto collection = Enumerable::from_array(values, sizeof(values) / sizeof(int));
     EXPECT_EQ(0, collection->first_or_default([](const int& n){ return n % 2 == 0; }, 0));
 }
+
+ENUMERABLE_TEST(FromQueue, Enumerates_a_live_stream_until_the_queue_is_closed)
+{
+    auto queue = std::make_shared<Concurrency::BoundedQueue<int> >(8);
+    auto evens = Enumerable::from_queue(queue)->where([](const int& n){ return n % 2 == 0; });
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < 4; ++p)
+    {
+        producers.push_back(std::thread([=]()
+        {
+            for (int n = p * 1000; n < (p + 1) * 1000; ++n)
+                queue->push(n);
+        }));
+    }
+
+    std::thread closer([&]()
+    {
+        for (auto& producer : producers)
+            producer.join();
+        queue->close();
+    });
+
+    EXPECT_EQ(static_cast<size_t>(2000), evens->count());
+    closer.join();
+
+    EXPECT_FALSE(queue->push(1));
+    EXPECT_EQ(static_cast<size_t>(0), evens->count());
+}
+
+ENUMERABLE_TEST(FromQueue, Shares_out_the_elements_between_concurrent_consumers)
+{
+    auto queue = std::make_shared<Concurrency::BoundedQueue<int64_t> >(64);
+    auto stream = Enumerable::from_queue(queue, Enumerators::QueueWait::Spin);
+
+    int64_t sums[2] = { 0, 0 };
+    std::thread first([&](){ sums[0] = stream->sum(); });
+    std::thread second([&](){ sums[1] = stream->sum(); });
+
+    for (int64_t n = 1; n <= 100000; ++n)
+        queue->push(n);
+    queue->close();
+
+    first.join();
+    second.join();
+
+    EXPECT_EQ(100000LL * 100001 / 2, sums[0] + sums[1]);
+}
+
+ENUMERABLE_TEST(FromQueue, Ends_the_enumeration_when_nothing_arrives_within_the_timeout)
+{
+    auto queue = std::make_shared<Concurrency::BoundedQueue<std::string> >(4);
+    auto stream = Enumerable::from_queue(queue, std::chrono::milliseconds(10));
+
+    ASSERT_TRUE(queue->try_push(std::string("first")));
+    ASSERT_TRUE(queue->try_push(std::string("second")));
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(std::vector<std::string>({ "first", "second" }), stream->to_vector());
+    EXPECT_LE(std::chrono::milliseconds(10), std::chrono::steady_clock::now() - start);
+
+    ASSERT_TRUE(queue->try_push(std::string("third")));
+    EXPECT_EQ("third", stream->first());
+    EXPECT_FALSE(queue->closed());
+}
+
+ENUMERABLE_TEST(FromQueue, Rejects_pushes_once_the_queue_is_full)
+{
+    Concurrency::BoundedQueue<std::unique_ptr<int> > queue(2);
+    std::unique_ptr<int> value(new int(3));
+
+    EXPECT_TRUE(queue.try_push(std::unique_ptr<int>(new int(1))));
+    EXPECT_TRUE(queue.try_push(std::unique_ptr<int>(new int(2))));
+    EXPECT_FALSE(queue.try_push(std::move(value)));
+    ASSERT_NE(nullptr, value);
+
+    Optional<std::unique_ptr<int> > popped;
+    ASSERT_TRUE(queue.try_pop(popped));
+    EXPECT_EQ(1, **popped);
+    EXPECT_TRUE(queue.try_push(std::move(value)));
+}
+
+ENUMERABLE_TEST(GroupBy, Groups_elements_by_key_in_key_order_keeping_their_source_order)
+{
+    std::vector<std::string> words = { "pear", "fig", "plum", "apple", "kiwi", "date" };
+    auto groups = Enumerable::from(words)
+        ->group_by<size_t>([](const std::string& word){ return word.size(); })
+        ->to_vector();
+
+    ASSERT_EQ(3u, groups.size());
+    EXPECT_EQ(3u, groups[0].first);
+    EXPECT_EQ(std::vector<std::string>({ "fig" }), groups[0].second);
+    EXPECT_EQ(4u, groups[1].first);
+    EXPECT_EQ(std::vector<std::string>({ "pear", "plum", "kiwi", "date" }), groups[1].second);
+    EXPECT_EQ(5u, groups[2].first);
+    EXPECT_EQ(std::vector<std::string>({ "apple" }), groups[2].second);
+}
+
+ENUMERABLE_TEST(GroupBy, Spills_partitions_to_disk_once_over_the_memory_budget)
+{
+    auto collection = Enumerable::range(0, 10000);
+    std::function<int(const int&)> lastDigit = [](const int& n){ return n % 10; };
+    uint64_t spillFiles = Spill::SpillFile::created();
+
+    auto groups = collection->group_by<int>(lastDigit, 1024)->to_map<int>([](const std::pair<int, std::vector<int> >& group)
+    {
+        return group.first;
+    });
+
+    EXPECT_LT(spillFiles, Spill::SpillFile::created());
+    EXPECT_EQ(collection->group_by<int>(lastDigit)->to_map<int>([](const std::pair<int, std::vector<int> >& group)
+    {
+        return group.first;
+    }), groups);
+}
+
+ENUMERABLE_TEST(GroupBy, Partitions_again_any_partition_over_the_memory_budget)
+{
+    auto collection = Enumerable::range(0, 20000);
+    std::function<int(const int&)> key = [](const int& n){ return n % 200; };
+    auto byKey = [](const std::pair<int, std::vector<int> >& group){ return group.first; };
+    uint64_t spillFiles = Spill::SpillFile::created();
+
+    auto groups = collection->group_by<int>(key, 1024)->to_map<int>(byKey);
+
+    // A single level of partitioning leaves about six groups of a hundred elements in each partition.
+    EXPECT_LT(spillFiles + 32, Spill::SpillFile::created());
+    EXPECT_EQ(collection->group_by<int>(key)->to_map<int>(byKey), groups);
+}
+
+ENUMERABLE_TEST(GroupBy, Puts_both_zeros_in_the_same_group_once_spilled)
+{
+    auto collection = Enumerable::range(0, 20000);
+    auto groups = collection->group_by<double>([](const int& n)
+    {
+        return n % 100 != 0 ? n % 100 : (n % 200 == 0 ? 0.0 : -0.0);
+    }, 1024)->to_vector();
+
+    ASSERT_EQ(100u, groups.size());
+    auto zeros = Enumerable::from(groups)->first([](const std::pair<double, std::vector<int> >& group){ return group.first == 0; });
+    EXPECT_EQ(200u, zeros.second.size());
+}
+
+ENUMERABLE_TEST(IncrementalAggregate, Folds_in_only_the_elements_appended_since_the_last_evaluation)
+{
+    std::shared_ptr<std::vector<int> > readings(new std::vector<int>({ 1, 2, 3, 4 }));
+    std::shared_ptr<int> evaluated(new int(0));
+
+    auto average = Enumerable::from_append_only(readings)
+        ->where([](const int& n){ return n % 2 == 0; })
+        ->select<double>([=](const int& n){ ++*evaluated; return n; })
+        ->incremental_aggregate<std::pair<double, size_t>, double>(
+            std::make_pair(0.0, size_t(0)),
+            [](const std::pair<double, size_t>& acc, const double& x){ return std::make_pair(acc.first + x, acc.second + 1); },
+            [](const std::pair<double, size_t>& acc){ return acc.first / acc.second; });
+
+    EXPECT_EQ(3.0, average.value());
+    EXPECT_EQ(2, *evaluated);
+    EXPECT_EQ(3.0, average.value());
+    EXPECT_EQ(2, *evaluated);
+
+    readings->push_back(5);
+    readings->push_back(12);
+
+    EXPECT_EQ(6.0, average.value());
+    EXPECT_EQ(3, *evaluated);
+    EXPECT_EQ(3u, average.watermark());
+
+    average.reset();
+    EXPECT_EQ(6.0, average.value());
+    EXPECT_EQ(6, *evaluated);
+}
+
+ENUMERABLE_TEST(IncrementalAggregate, Maintains_an_aggregate_per_key)
+{
+    std::shared_ptr<std::deque<std::string> > words(new std::deque<std::string>({ "fig", "pear", "kiwi" }));
+
+    auto counts = Enumerable::from_append_only(words)->incremental_aggregate_by<size_t, int>(
+        [](const std::string& word){ return word.size(); }, 0,
+        [](const int& count, const std::string&){ return count + 1; });
+
+    EXPECT_EQ((std::map<size_t, int>{ { 3, 1 }, { 4, 2 } }), counts.value());
+
+    words->push_back("apple");
+    words->push_back("plum");
+
+    EXPECT_EQ((std::map<size_t, int>{ { 3, 1 }, { 4, 3 }, { 5, 1 } }), counts.value());
+    EXPECT_EQ(5u, counts.watermark());
+}
+
+ENUMERABLE_TEST(IncrementalAggregate, Errors_if_the_query_cannot_pick_up_appended_elements)
+{
+    std::shared_ptr<std::vector<int> > readings(new std::vector<int>({ 1, 2, 3 }));
+    auto stream = Enumerable::from_append_only(readings);
+    std::function<int(const int&, const int&)> add = [](const int& sum, const int& n){ return sum + n; };
+
+    EXPECT_THROW(stream->concat(stream)->incremental_aggregate<int>(0, add), std::runtime_error);
+    EXPECT_THROW(stream->skip(1)->incremental_aggregate<int>(0, add), std::runtime_error);
+    EXPECT_THROW(stream->order_by<int>([](const int& n){ return n; })->incremental_aggregate<int>(0, add), std::runtime_error);
+    EXPECT_THROW(Enumerable::from(*readings)->incremental_aggregate<int>(0, add), std::runtime_error);
+
+    auto sum = stream->distinct()->consume()->incremental_aggregate<int>(0, add);
+    EXPECT_EQ(6, sum.value());
+    readings->push_back(3);
+    readings->push_back(4);
+    EXPECT_EQ(10, sum.value());
+}
+
+ENUMERABLE_TEST(Indexed, Gives_random_access_iterators_over_random_access_queries)
+{
+    auto squares = Enumerable::range(0, 100)
+        ->skip(10)
+        ->select<int>([](const int& n){ return n * n; });
+
+    ASSERT_TRUE(squares->has_random_access());
+    auto indexed = squares->indexed();
+
+    ASSERT_EQ(static_cast<size_t>(90), indexed.size());
+    EXPECT_EQ(100, *indexed.begin());
+    EXPECT_EQ(99 * 99, *(indexed.end() - 1));
+    EXPECT_EQ(50 * 50, indexed[40]);
+    EXPECT_EQ(90, indexed.end() - indexed.begin());
+    EXPECT_EQ(indexed.begin() + 39, std::lower_bound(indexed.begin(), indexed.end(), 49 * 49 - 1));
+    EXPECT_EQ(squares->sum(), std::accumulate(indexed.begin(), indexed.end(), 0));
+
+    std::vector<int> reversed(std::reverse_iterator<RandomAccessIterator<int> >(indexed.end()),
+        std::reverse_iterator<RandomAccessIterator<int> >(indexed.begin()));
+    EXPECT_EQ(99 * 99, reversed.front());
+    EXPECT_EQ(100, reversed.back());
+    EXPECT_TRUE((std::is_same<std::random_access_iterator_tag, std::iterator_traits<RandomAccessIterator<int> >::iterator_category>::value));
+}
+
+ENUMERABLE_TEST(Indexed, Gives_each_copy_of_an_iterator_its_own_position)
+{
+    std::vector<int64_t> values;
+    for (int i = 0; i < 100000; ++i)
+        values.push_back(i);
+
+    auto indexed = Enumerable::from(values)->indexed();
+    const size_t half = indexed.size() / 2;
+
+    int64_t low = 0;
+    int64_t high = 0;
+    std::thread first([&](){ low = std::accumulate(indexed.begin(), indexed.begin() + half, int64_t(0)); });
+    std::thread second([&](){ high = std::accumulate(indexed.begin() + half, indexed.end(), int64_t(0)); });
+    first.join();
+    second.join();
+
+    EXPECT_EQ(Enumerable::from(values)->sum(), low + high);
+}
+
+#if __cplusplus >= 201703L
+#ifdef _PSTL_VERSION
+// libstdc++ runs an algorithm given std::execution::par serially unless every iterator passes this check.
+static_assert(__pstl::__internal::__is_random_access_iterator<RandomAccessIterator<int64_t> >::value,
+    "The parallel algorithms should split the work over indexed iterators");
+#endif
+
+ENUMERABLE_TEST(Indexed, Can_be_handed_to_algorithms_with_an_execution_policy)
+{
+    auto doubled = Enumerable::range<int64_t>(0, 100000)->select<int64_t>([](const int64_t& n){ return n * 2; });
+    auto indexed = doubled->indexed();
+
+    EXPECT_EQ(doubled->sum(), std::reduce(std::execution::par, indexed.begin(), indexed.end(), int64_t(0)));
+    EXPECT_EQ(doubled->sum() * 2, std::transform_reduce(std::execution::par, indexed.begin(), indexed.end(), int64_t(0),
+        std::plus<int64_t>(), [](const int64_t& n){ return n * 2; }));
+}
+#endif
+
+ENUMERABLE_TEST(Indexed, Errors_if_the_query_does_not_support_random_access)
+{
+    auto evens = Enumerable::range(0, 10)->where([](const int& n){ return n % 2 == 0; });
+
+    EXPECT_FALSE(evens->has_random_access());
+    EXPECT_THROW(evens->indexed(), std::runtime_error);
+    EXPECT_THROW(*Enumerable::range(0, 3)->indexed().end(), std::out_of_range);
+
+    auto linked = Enumerable::from(std::list<int>({ 1, 2, 3 }));
+    EXPECT_FALSE(linked->has_random_access());
+    EXPECT_EQ(2, linked->element_at(1));
+}
+
+#if __cplusplus > 201703L
+static_assert(std::ranges::input_range<IEnumerable<int> >, "IEnumerable should be a range");
+static_assert(std::ranges::common_range<IEnumerable<int> >, "IEnumerable should be a common range");
+static_assert(std::ranges::random_access_range<IndexedRange<int> >, "IndexedRange should be random access");
+static_assert(std::ranges::sized_range<IndexedRange<int> >, "IndexedRange should be sized");
+#endif
+
+ENUMERABLE_TEST(Iterators, Are_used_to_iterate_over_the_collection)
+{
+    std::vector<int> values;
+    values.push_back(25);
+    values.push_back(-25);
+
+    auto collection = Enumerable::from(values);
+
+    std::vector<int>::iterator expected = values.begin();
+    IEnumerable<int>::iterator actual = collection->begin();
+
+    EXPECT_EQ(*expected, *actual);
+    ++expected; ++actual;
+    EXPECT_EQ(*expected, *actual);
+    ++expected;  ++actual;
+    EXPECT_EQ(collection->end(), actual);
+}
+
+ENUMERABLE_TEST(Iterators, Work_with_the_standard_algorithms)
+{
+    auto evens = Enumerable::range(0, 10)->where([](const int& n){ return n % 2 == 0; });
+
+    std::vector<int> values(evens->begin(), evens->end());
+
+    EXPECT_EQ(std::vector<int>({ 0, 2, 4, 6, 8 }), values);
+    EXPECT_EQ(20, std::accumulate(evens->begin(), evens->end(), 0));
+    EXPECT_TRUE((std::is_same<std::input_iterator_tag, std::iterator_traits<IEnumerable<int>::iterator>::iterator_category>::value));
+}
+
+ENUMERABLE_TEST(Memoize, Runs_the_query_once_for_several_terminal_operators)
+{
+    std::shared_ptr<int> evaluated(new int(0));
+    auto query = Enumerable::range(0, 100)
+        ->select<int>([=](const int& n){ ++*evaluated; return n * 2; })
+        ->memoize();
+
+    EXPECT_EQ(0, query->first());
+    EXPECT_EQ(1, *evaluated);
+
+    EXPECT_EQ(100u, query->count());
+    EXPECT_TRUE(query->any([](const int& n){ return n == 198; }));
+    EXPECT_EQ(9900, query->sum());
+    EXPECT_EQ(100, *evaluated);
+}
+
+ENUMERABLE_TEST(Memoize, Becomes_random_access_once_recorded)
+{
+    auto query = Enumerable::range(0, 10)->where([](const int& n){ return n % 2 == 1; })->memoize();
+
+    EXPECT_FALSE(query->has_random_access());
+    EXPECT_EQ(5u, query->count());
+    EXPECT_TRUE(query->has_random_access());
+    EXPECT_EQ(7, query->element_at(3));
+    EXPECT_EQ(std::vector<int>({ 5, 7, 9 }), query->skip(2)->to_vector());
+}
+
+ENUMERABLE_TEST(Memoize, Shares_the_recording_between_concurrent_readers)
+{
+    std::shared_ptr<std::atomic<int> > evaluated(new std::atomic<int>(0));
+    auto query = Enumerable::range(0, 10000)
+        ->select<int64_t>([=](const int& n){ ++*evaluated; return static_cast<int64_t>(n); })
+        ->memoize();
+
+    std::vector<int64_t> sums(4);
+    std::vector<std::thread> readers;
+    for (size_t i = 0; i < sums.size(); ++i)
+    {
+        readers.push_back(std::thread([&, i]()
+        {
+            sums[i] = query->sum();
+        }));
+    }
+
+    for (std::thread& reader : readers)
+    {
+        reader.join();
+    }
+
+    EXPECT_EQ(std::vector<int64_t>(4, 49995000), sums);
+    EXPECT_EQ(10000, evaluated->load());
+}
+
+ENUMERABLE_TEST(OrderBy, Sorts_by_key_keeping_the_source_order_of_equal_keys)
+{
+    std::vector<std::string> words = { "pear", "fig", "plum", "apple", "kiwi", "date" };
+    auto sorted = Enumerable::from(words)
+        ->order_by<size_t>([](const std::string& word){ return word.size(); })
+        ->to_vector();
+
+    EXPECT_EQ(std::vector<std::string>({ "fig", "pear", "plum", "kiwi", "date", "apple" }), sorted);
+}
+
+ENUMERABLE_TEST(OrderBy, Merges_runs_spilled_to_disk_once_over_the_memory_budget)
+{
+    std::vector<std::string> values;
+    for (int i = 0; i < 5000; ++i)
+    {
+        values.push_back(std::to_string((i * 7919) % 1000) + "/" + std::to_string(i));
+    }
+
+    std::function<int(const std::string&)> prefix = [](const std::string& s){ return std::stoi(s); };
+    uint64_t spillFiles = Spill::SpillFile::created();
+
+    auto query = Enumerable::from(values)->order_by<int>(prefix, 4096);
+    std::vector<std::string> sorted = query->to_vector();
+
+    EXPECT_LT(spillFiles + 1, Spill::SpillFile::created());
+    EXPECT_EQ(Enumerable::from(values)->order_by<int>(prefix)->to_vector(), sorted);
+    EXPECT_EQ(sorted, query->to_vector());
+}
+
+ENUMERABLE_TEST(OrderBy, Sorts_once_on_the_first_pull_rather_than_when_the_query_is_built)
+{
+    int keys = 0;
+    auto sorted = Enumerable::range(0, 1000)->order_by<int>([&](const int& n){ ++keys; return -n; });
+    auto query = sorted
+        ->where([](const int& n){ return n % 2 == 0; })
+        ->select<int>([](const int& n){ return n / 2; });
+
+    EXPECT_TRUE(sorted->has_random_access());
+    EXPECT_EQ(0, keys);
+    EXPECT_EQ(500u, query->count());
+    EXPECT_EQ(1000, keys);
+    EXPECT_EQ(999, sorted->element_at(0));
+
+    auto queue = std::make_shared<Concurrency::BoundedQueue<int> >(4);
+    auto groups = Enumerable::from_queue(queue)->group_by<int>([](const int& n){ return n % 2; });
+    EXPECT_TRUE(groups->has_random_access());
+    queue->push(1);
+    queue->close();
+    EXPECT_EQ(1u, groups->count());
+}
+
+ENUMERABLE_TEST(Sample, Draws_the_same_uniform_sample_for_the_same_seed)
+{
+    auto range = Enumerable::range(0, 10);
+    auto filtered = range->where([](const int&){ return true; });
+
+    std::vector<int> sample = range->sample(3, 42)->to_vector();
+    EXPECT_EQ(3u, sample.size());
+    EXPECT_EQ(sample, range->sample(3, 42)->to_vector());
+    EXPECT_EQ(sample, filtered->sample(3, 42)->to_vector());
+    EXPECT_EQ(10u, range->sample(20)->count());
+    EXPECT_EQ(0u, range->sample(0)->count());
+
+    std::vector<int> picked(10);
+    for (uint64_t seed = 0; seed < 3000; ++seed)
+    {
+        for (int n : filtered->sample(3, seed)->to_vector())
+            ++picked[n];
+    }
+    for (int count : picked)
+        EXPECT_NEAR(900, count, 120);
+}
+
+ENUMERABLE_TEST(Sample, Seeks_to_the_picked_elements_of_a_random_access_source)
+{
+    auto range = Enumerable::range<uint64_t>(0, 1000000000);
+
+    std::vector<uint64_t> sample = range->sample(5, 7)->to_vector();
+    std::sort(sample.begin(), sample.end());
+    EXPECT_EQ(sample.end(), std::unique(sample.begin(), sample.end()));
+    EXPECT_LT(sample.back(), static_cast<uint64_t>(1000000000));
+    EXPECT_GT(sample.back(), static_cast<uint64_t>(100000000));
+}
+
+ENUMERABLE_TEST(Sample, Draws_the_sample_on_the_first_pull_rather_than_when_the_query_is_built)
+{
+    int read = 0;
+    auto sampled = Enumerable::range(0, 100)
+        ->where([&](const int&){ ++read; return true; })
+        ->sample(10, 5);
+    auto query = sampled->select<int>([](const int& n){ return n * 2; });
+
+    EXPECT_TRUE(sampled->has_random_access());
+    EXPECT_EQ(0, read);
+    EXPECT_EQ(10u, query->to_vector().size());
+    EXPECT_EQ(100, read);
+}
+
+ENUMERABLE_TEST(SampleFraction, Keeps_each_element_with_the_given_probability)
+{
+    auto range = Enumerable::range(0, 100000);
+    auto filtered = range->where([](const int&){ return true; });
+
+    std::vector<int> sample = range->sample_fraction(0.01, 3)->to_vector();
+    EXPECT_NEAR(1000, static_cast<double>(sample.size()), 150);
+    EXPECT_TRUE(std::is_sorted(sample.begin(), sample.end()));
+    EXPECT_EQ(sample, range->sample_fraction(0.01, 3)->to_vector());
+    EXPECT_EQ(sample, filtered->sample_fraction(0.01, 3)->to_vector());
+
+    auto sampled = filtered->sample_fraction(0.01, 3);
+    std::vector<int> pulled;
+    for (int n : *sampled)
+        pulled.push_back(n);
+    EXPECT_EQ(sample, pulled);
+
+    EXPECT_EQ(100000u, filtered->sample_fraction(1.0)->count());
+    EXPECT_EQ(0u, range->sample_fraction(0.0)->count());
+    EXPECT_THROW(range->sample_fraction(1.5), std::out_of_range);
+}
+
+ENUMERABLE_TEST(Select, Projects_each_element_of_the_collection_using_the_given_selector)
+{
+    int values[] = { 1, 2, 3 };
+    auto collection = Enumerable::from_array(values, sizeof(values) / sizeof(int));
+
+    auto squares = collection->select<int>([](const int& n){ return n * n; });
+
+    EXPECT_EQ(14, squares->aggregate([](const int& acc, const int& n){ return acc + n; }));
+}
+
+ENUMERABLE_TEST(Select, Fuses_consecutive_selectors_and_casts)
+{
+    int values[] = { 1, 2, 3 };
+    auto collection = Enumerable::from_array(values, sizeof(values) / sizeof(int));
+
+    auto result = collection
+        ->select<int>([](const int& n){ return n * 10; })
+        ->select<std::string>([](const int& n){ return std::to_string(n); })
+        ->aggregate<std::string>("", [](const std::string& acc, const std::string& s){ return acc + s + ";"; });
+
+    EXPECT_EQ(std::string("10;20;30;"), result);
+
+    double fractions[] = { 1.7, -2.5, 300.9 };
+    auto source = Enumerable::from_array(fractions, 3);
+    auto truncated = source->cast<int>()->cast<int8_t>();
+
+    EXPECT_EQ(1, truncated->element_at(0));
+    EXPECT_EQ(-2, truncated->element_at(1));
+    EXPECT_EQ(static_cast<int8_t>(300), truncated->element_at(2));
+}
+
+ENUMERABLE_TEST(TumblingWindow, Groups_consecutive_elements_by_window_of_time)
+{
+    std::vector<int> timestamps = { -3, 1, 4, 9, 10, 11, 25, 29 };
+    auto windows = Enumerable::from(timestamps)
+        ->tumbling_window<int, int>([](const int& t){ return t; }, 10)
+        ->to_vector();
+
+    std::vector<std::vector<int> > expected = { { -3 }, { 1, 4, 9 }, { 10, 11 }, { 25, 29 } };
+    EXPECT_EQ(expected, windows);
+}
+
+ENUMERABLE_TEST(TumblingWindow, Accepts_time_points)
+{
+    typedef std::chrono::system_clock::time_point Time;
+    std::vector<Time> times;
+    for (int seconds : { 0, 30, 59, 60, 150 })
+    {
+        times.push_back(Time(std::chrono::seconds(seconds)));
+    }
+
+    auto counts = Enumerable::from(times)
+        ->tumbling_window<Time>([](const Time& t){ return t; }, std::chrono::minutes(1))
+        ->select<size_t>([](const std::vector<Time>& window){ return window.size(); })
+        ->to_vector();
+
+    EXPECT_EQ(std::vector<size_t>({ 3, 1, 1 }), counts);
+}
+
+ENUMERABLE_TEST(Where, Filters_the_collection_using_the_given_predicate)
+{
+    int values[] = { 1, 2, 3, 4, 5, 6 };
+    auto collection = Enumerable::from_array(values, sizeof(values) / sizeof(int));
+
+    auto evens = collection->where([](const int& n){ return n % 2 == 0; });
+
+    EXPECT_EQ(12, evens->aggregate([](const int& acc, const int& n){ return acc + n; }));
+}
+
+ENUMERABLE_TEST(Where, Fuses_consecutive_predicates_without_changing_the_upstream_query)
+{
+    std::vector<int> values;
+    for (int i = 0; i < 30; ++i)
+        values.push_back(i);
+
+    auto collection = Enumerable::from(values);
+    auto evens = collection->where([](const int& n){ return n % 2 == 0; });
+    auto evenMultiplesOfThree = evens->where([](const int& n){ return n % 3 == 0; });
+    auto evenMultiplesOfFifteen = evenMultiplesOfThree->where([](const int& n){ return n % 5 == 0; });
+
+    EXPECT_EQ(static_cast<size_t>(15), evens->count());
+    EXPECT_EQ(static_cast<size_t>(5), evenMultiplesOfThree->count());
+    EXPECT_EQ(static_cast<size_t>(1), evenMultiplesOfFifteen->count());
+}
+
+ENUMERABLE_TEST(Where, Fuses_a_predicate_with_the_selector_that_follows_it)
+{
+    int values[] = { 1, 2, 3, 4, 5, 6 };
+    auto collection = Enumerable::from_array(values, sizeof(values) / sizeof(int));
+
+    auto result = collection
+        ->where([](const int& n){ return n > 2; })
+        ->where([](const int& n){ return n < 6; })
+        ->select<int>([](const int& n){ return n * n; })
+        ->select<double>([](const int& n){ return n / 2.0; });
+
+    EXPECT_EQ(static_cast<size_t>(3), result->count());
+    EXPECT_DOUBLE_EQ(4.5, result->first());
+    EXPECT_DOUBLE_EQ(25.0, result->aggregate([](const double& acc, const double& n){ return acc + n; }));
+}
+
+ENUMERABLE_TEST(Where, Builds_the_query_without_creating_enumerators)
+{
+    int made = 0;
+    auto counted = make_source<int>("counted", [&]()
+    {
+        ++made;
+        return std::make_shared<Enumerators::ArithmeticSequence<int> >(0, 1, 10);
+    });
+
+    auto query = counted
+        ->where([](const int& n){ return n % 2 == 0; })
+        ->where([](const int& n){ return n > 2; })
+        ->select<int>([](const int& n){ return n * 10; });
+    auto adaptive = counted->where([](const int& n){ return n > 2; })->adaptive();
+
+    EXPECT_EQ(0, made);
+    EXPECT_EQ(std::vector<int>({ 40, 60, 80 }), query->to_vector());
+    EXPECT_EQ(1, made);
+}
+
+ENUMERABLE_TEST(Window, Produces_each_full_window_of_consecutive_elements)
+{
+    auto windows = Enumerable::range(1, 7)->window(3, 2)->to_vector();
+
+    std::vector<std::vector<int> > expected = { { 1, 2, 3 }, { 3, 4, 5 }, { 5, 6, 7 } };
+    EXPECT_EQ(expected, windows);
+    EXPECT_EQ(0u, Enumerable::range(1, 2)->window(3)->count());
+}
+
+ENUMERABLE_TEST(Window, Aggregates_each_window_incrementally)
+{
+    std::vector<int> values;
+    for (int i = 0; i < 200; ++i)
+    {
+        values.push_back((i * 7919) % 101 - 50);
+    }
+
+    for (size_t step : { 1, 3 })
+    {
+        auto query = Enumerable::from(values)->where([](const int& n){ return n != 0; });
+        std::vector<int> filtered = query->to_vector();
+
+        std::vector<int> sums, mins, maxes;
+        std::vector<double> averages;
+        for (size_t start = 0; start + 10 <= filtered.size(); start += step)
+        {
+            auto first = filtered.begin() + start;
+            sums.push_back(std::accumulate(first, first + 10, 0));
+            averages.push_back(sums.back() / 10.0);
+            mins.push_back(*std::min_element(first, first + 10));
+            maxes.push_back(*std::max_element(first, first + 10));
+        }
+
+        EXPECT_EQ(sums, query->window_sum(10, step)->to_vector());
+        EXPECT_EQ(averages, query->window_average(10, step)->to_vector());
+        EXPECT_EQ(mins, query->window_min(10, step)->to_vector());
+        EXPECT_EQ(maxes, query->window_max(10, step)->to_vector());
+    }
+}
+
+ENUMERABLE_TEST(Window, Sums_and_averages_without_accumulating_rounding_errors)
+{
+    std::vector<double> values;
+    for (int i = 0; i < 10000; ++i)
+    {
+        values.push_back(i % 1000 == 0 ? 1e15 : 0.1 * (i % 7));
+    }
+
+    std::vector<double> sums = Enumerable::from(values)->window_sum(10)->to_vector();
+    std::vector<double> averages = Enumerable::from(values)->window_average(10)->to_vector();
+    ASSERT_EQ(values.size() - 9, sums.size());
+    ASSERT_EQ(values.size() - 9, averages.size());
+    for (size_t start = 0; start < averages.size(); ++start)
+    {
+        double expected = std::accumulate(values.begin() + start, values.begin() + start + 10, 0.0);
+        EXPECT_NEAR(expected, sums[start], std::fabs(expected) * 1e-14 + 1e-11) << start;
+        EXPECT_NEAR(expected / 10, averages[start], std::fabs(expected / 10) * 1e-14 + 1e-12) << start;
+    }
+
+    std::vector<int64_t> large(100, int64_t(1) << 60);
+    large.push_back(3);
+    EXPECT_EQ(3.0, Enumerable::from(large)->window_average(1)->to_vector().back());
+}
+
+ENUMERABLE_TEST(Window, Errors_if_the_size_or_step_is_zero)
+{
+    auto collection = Enumerable::range(0, 10);
+    EXPECT_THROW(collection->window(0), std::runtime_error);
+    EXPECT_THROW(collection->window_sum(3, 0), std::runtime_error);
+}
+
+ENUMERABLE_TEST(ToFlatMap, Keeps_the_first_element_for_each_key_in_insertion_order)
+{
+    auto words = Enumerable::from(std::vector<std::string>({ "pear", "apple", "plum", "avocado", "cherry" }));
+
+    FlatMap<char, std::string> byInitial = words->to_flat_map<char>([](const std::string& s){ return s[0]; });
+    EXPECT_EQ(3u, byInitial.size());
+    EXPECT_EQ("pear", byInitial.at('p'));
+    EXPECT_EQ("apple", *byInitial.find('a'));
+    EXPECT_EQ(nullptr, byInitial.find('z'));
+    EXPECT_THROW(byInitial.at('z'), std::out_of_range);
+    EXPECT_EQ('p', byInitial.begin()->first);
+
+    auto squares = Enumerable::range(0, 10000)->to_flat_map<int, int>([](const int& n){ return n * 1024; }, [](const int& n){ return n * n; });
+    EXPECT_EQ(10000u, squares.size());
+    for (int n = 0; n < 10000; ++n)
+        EXPECT_EQ(n * n, squares.at(n * 1024));
+    EXPECT_FALSE(squares.contains(1));
+
+    auto lengths = words->to_unordered_map<char, size_t>([](const std::string& s){ return s[0]; }, [](const std::string& s){ return s.size(); });
+    EXPECT_EQ(3u, lengths.size());
+    EXPECT_EQ(5u, lengths.at('a'));
+}
+
+ENUMERABLE_TEST(ToLookup, Groups_every_element_by_key_in_one_contiguous_array)
+{
+    auto lookup = Enumerable::range(0, 10)->to_lookup<int>([](const int& n){ return n % 3; });
+
+    EXPECT_EQ(3u, lookup.size());
+    EXPECT_EQ(std::vector<int>({ 0, 3, 6, 9 }), std::vector<int>(lookup[0].begin(), lookup[0].end()));
+    EXPECT_EQ(std::vector<int>({ 2, 5, 8 }), std::vector<int>(lookup[2].begin(), lookup[2].end()));
+    EXPECT_EQ(lookup[0].end(), lookup[1].begin());
+    EXPECT_TRUE(lookup[3].empty());
+    EXPECT_FALSE(lookup.contains(3));
+    EXPECT_EQ(1, lookup.key(1));
+    EXPECT_EQ(7, lookup.values(1)[2]);
+
+    std::vector<std::unique_ptr<int> > owned;
+    owned.push_back(std::unique_ptr<int>(new int(1)));
+    owned.push_back(std::unique_ptr<int>(new int(2)));
+    auto moved = Enumerable::from(std::move(owned))->consume()->to_lookup<bool>([](const std::unique_ptr<int>& p){ return *p > 1; });
+    EXPECT_EQ(2, *moved[true][0]);
+}
+
+ENUMERABLE_TEST(ToVector, Materializes_the_collection)
+{
+    auto range = Enumerable::range(1, 5);
+    auto squares = range->select<int>([](const int& n){ return n * n; });
+
+    std::vector<int> vector = squares->to_vector();
+    EXPECT_EQ(std::vector<int>({ 1, 4, 9, 16, 25 }), vector);
+    EXPECT_EQ(static_cast<size_t>(5), range->to_vector().capacity());
+
+    std::deque<int> deque = squares->to_deque();
+    EXPECT_EQ(std::deque<int>({ 1, 4, 9, 16, 25 }), deque);
+    EXPECT_EQ(static_cast<size_t>(5), squares->to_list().size());
+}
+
+ENUMERABLE_TEST(TryElementAt, Returns_the_element_at_the_given_index_if_there_is_one)
+{
+    std::list<int> values({ 1, 2, 3 });
+    auto collection = Enumerable::from(values);
+
+    Optional<int> hit = collection->try_element_at(2);
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_EQ(3, *hit);
+    EXPECT_FALSE(collection->try_element_at(3).has_value());
+    EXPECT_FALSE(Enumerable::empty<int>()->try_element_at(0).has_value());
+}
+
+ENUMERABLE_TEST(TryFirst, Returns_the_first_element_that_satisfies_the_given_predicate_if_there_is_one)
+{
+    auto range = Enumerable::range(1, 10);
+
+    EXPECT_EQ(1, range->try_first().value());
+    EXPECT_EQ(4, range->try_first([](const int& n){ return n % 4 == 0; }).value());
+    EXPECT_FALSE(range->try_first([](const int& n){ return n > 10; }));
+    EXPECT_EQ(-1, range->try_first([](const int& n){ return n > 10; }).value_or(-1));
+    EXPECT_THROW(range->try_first([](const int& n){ return n > 10; }).value(), std::runtime_error);
+}
+
+ENUMERABLE_TEST(TryLast, Returns_the_last_element_if_there_is_one)
+{
+    auto range = Enumerable::range(1, 10);
+    auto evens = range->where([](const int& n){ return n % 2 == 0; });
+
+    EXPECT_EQ(10, range->try_last().value());
+    EXPECT_EQ(10, evens->try_last().value());
+    EXPECT_FALSE(Enumerable::range(1, 0)->try_last().has_value());
+}
+
+ENUMERABLE_TEST(TrySingle, Returns_the_only_element_if_there_is_exactly_one)
+{
+    auto range = Enumerable::range(1, 10);
+    auto one = range->where([](const int& n){ return n == 7; });
+    auto two = range->where([](const int& n){ return n > 8; });
+
+    EXPECT_EQ(7, one->try_single().value());
+    EXPECT_FALSE(two->try_single().has_value());
+    EXPECT_EQ(3, Enumerable::range(3, 1)->try_single().value());
+    EXPECT_FALSE(range->try_single().has_value());
+
+    std::vector<std::unique_ptr<int> > values;
+    values.push_back(std::unique_ptr<int>(new int(42)));
+    auto pointers = Enumerable::from(std::move(values));
+    EXPECT_EQ(42, *pointers->consume()->try_single().value());
+}
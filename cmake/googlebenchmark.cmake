@@ -0,0 +1,17 @@
+include(ExternalProject)
+
+ExternalProject_Add(
+    googlebenchmark
+    GIT_REPOSITORY https://github.com/google/benchmark.git
+    CMAKE_ARGS -DCMAKE_BUILD_TYPE=Release -DBENCHMARK_ENABLE_TESTING=OFF -DBENCHMARK_ENABLE_GTEST_TESTS=OFF
+    INSTALL_COMMAND ""
+    UPDATE_COMMAND ""
+    PATCH_COMMAND ""
+)
+
+ExternalProject_Get_Property(googlebenchmark source_dir binary_dir)
+
+set(BENCHMARK_INCLUDE_DIR ${source_dir}/include)
+set(BENCHMARK_LIB ${binary_dir}/src/${CMAKE_STATIC_LIBRARY_PREFIX}benchmark${CMAKE_STATIC_LIBRARY_SUFFIX})
+
+include_directories(${BENCHMARK_INCLUDE_DIR})